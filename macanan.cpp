@@ -1,9 +1,239 @@
     #include <iostream>
     #include <vector>
     #include <string>
+    #include <cstdint>
+    #include <algorithm>
+    #include <atomic>
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+    #include <memory>
+    #include <chrono>
+    #include <random>
+    #include <iomanip>
+    #include <cstdio>
+    #include <cstdarg>
+    #include <cmath>
+    #include <cstring>
+    #include <unordered_map>
+    #include <sstream>
+
+    #if defined(__x86_64__) || defined(__i386__)
+    #define MACANAN_X86 1
+    #include <immintrin.h>
+    #elif defined(__SSE2__)
+    #include <emmintrin.h>
+    #endif
+
+    #ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+    #else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #endif
 
     using namespace std;
 
+    const int BOARD_WIDTH = 9;
+    const int BOARD_HEIGHT = 7;
+    const int BOARD_CELLS = BOARD_WIDTH * BOARD_HEIGHT;
+
+    // Satu bit per sel: bit ke-(y * BOARD_WIDTH + x) mewakili sel (x, y)
+    typedef uint64_t Bitboard;
+
+    // Sel yang bisa dimainkan, satu baris papan per 9 bit
+    constexpr Bitboard PLAYABLE_MASK =
+        (Bitboard(0b001111100) << (0 * BOARD_WIDTH)) |
+        (Bitboard(0b101111101) << (1 * BOARD_WIDTH)) |
+        (Bitboard(0b010000010) << (2 * BOARD_WIDTH)) |
+        (Bitboard(0b111111111) << (3 * BOARD_WIDTH)) |
+        (Bitboard(0b010000010) << (4 * BOARD_WIDTH)) |
+        (Bitboard(0b101111101) << (5 * BOARD_WIDTH)) |
+        (Bitboard(0b001111100) << (6 * BOARD_WIDTH));
+
+    // Arah gerakan yang mungkin: 4 pertama horizontal & vertikal, 4 terakhir diagonal
+    const int DIRECTION_COUNT = 8;
+    const int ORTHOGONAL_DIRECTIONS = 4;
+    constexpr int DIRECTIONS[DIRECTION_COUNT][2] = {
+        {0, 1}, {1, 0}, {0, -1}, {-1, 0},
+        {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+    };
+
+    // Lompatan Macan: melewati sel over lalu mendarat di sel landing
+    struct Jump {
+        int8_t over;
+        int8_t landing;
+    };
+
+    // Graf papan: satu-satunya sumber aturan garis mana yang sah
+    struct BoardGraph {
+        Bitboard neighbours[BOARD_CELLS];           // tetangga untuk langkah biasa
+        Bitboard orthogonalNeighbours[BOARD_CELLS]; // tetangga horizontal & vertikal saja
+        Jump jumps[BOARD_CELLS][DIRECTION_COUNT];
+        int jumpCount[BOARD_CELLS];
+    };
+
+    constexpr bool isPlayableCell(int x, int y) {
+        return x >= 0 && x < BOARD_WIDTH && y >= 0 && y < BOARD_HEIGHT &&
+               ((PLAYABLE_MASK >> (y * BOARD_WIDTH + x)) & 1) != 0;
+    }
+
+    constexpr BoardGraph buildBoardGraph() {
+        BoardGraph graph{};
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            int x = cell % BOARD_WIDTH;
+            int y = cell / BOARD_WIDTH;
+            if (!isPlayableCell(x, y)) continue;
+
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                int dx = DIRECTIONS[d][0];
+                int dy = DIRECTIONS[d][1];
+                if (!isPlayableCell(x + dx, y + dy)) continue;
+
+                int next = (y + dy) * BOARD_WIDTH + (x + dx);
+                graph.neighbours[cell] |= Bitboard(1) << next;
+                if (d < ORTHOGONAL_DIRECTIONS) {
+                    graph.orthogonalNeighbours[cell] |= Bitboard(1) << next;
+                }
+
+                // Lompatan hanya sah di sepanjang garis lurus yang sama
+                if (isPlayableCell(x + 2 * dx, y + 2 * dy)) {
+                    Jump& jump = graph.jumps[cell][graph.jumpCount[cell]++];
+                    jump.over = int8_t(next);
+                    jump.landing = int8_t((y + 2 * dy) * BOARD_WIDTH + (x + 2 * dx));
+                }
+            }
+        }
+        return graph;
+    }
+
+    constexpr BoardGraph BOARD_GRAPH = buildBoardGraph();
+
+    // Skor posisi berdasarkan jarak Manhattan dari tengah papan
+    constexpr int centralityScore(int x, int y) {
+        int dx = x - BOARD_WIDTH / 2;
+        int dy = y - BOARD_HEIGHT / 2;
+        return 10 - ((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy));
+    }
+
+    struct CellTable {
+        int value[BOARD_CELLS];
+    };
+
+    constexpr CellTable buildCentralityTable() {
+        CellTable table{};
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            table.value[cell] = centralityScore(cell % BOARD_WIDTH, cell / BOARD_WIDTH);
+        }
+        return table;
+    }
+
+    constexpr CellTable CELL_CENTRALITY = buildCentralityTable();
+
+    // Jumlah bidak yang ditempatkan di awal permainan
+    const int MACAN_COUNT = 2;
+    const int UWONG_COUNT = 8;
+
+    // Kunci Zobrist untuk hash posisi yang diperbarui secara inkremental
+    struct ZobristKeys {
+        uint64_t macan[BOARD_CELLS];
+        uint64_t uwong[BOARD_CELLS];
+        uint64_t uwongToMove;
+        uint64_t remainingMacan[MACAN_COUNT + 1];
+        uint64_t remainingUwong[UWONG_COUNT + 1];
+    };
+
+    constexpr uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys buildZobristKeys() {
+        ZobristKeys keys{};
+        uint64_t seed = 0x4D4143414E414EULL;
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            keys.macan[cell] = splitMix64(seed);
+            keys.uwong[cell] = splitMix64(seed);
+        }
+        keys.uwongToMove = splitMix64(seed);
+        for (int i = 0; i <= MACAN_COUNT; i++) keys.remainingMacan[i] = splitMix64(seed);
+        for (int i = 0; i <= UWONG_COUNT; i++) keys.remainingUwong[i] = splitMix64(seed);
+        return keys;
+    }
+
+    constexpr ZobristKeys ZOBRIST = buildZobristKeys();
+
+    inline int cellIndex(int x, int y) {
+        return y * BOARD_WIDTH + x;
+    }
+
+    inline Bitboard cellBit(int x, int y) {
+        if (x < 0 || x >= BOARD_WIDTH || y < 0 || y >= BOARD_HEIGHT) {
+            return 0;
+        }
+        return Bitboard(1) << cellIndex(x, y);
+    }
+
+    inline int popCount(Bitboard b) {
+        return __builtin_popcountll(b);
+    }
+
+    // Ambil indeks sel terendah lalu hapus bitnya dari b
+    inline int popLowestCell(Bitboard& b) {
+        int cell = __builtin_ctzll(b);
+        b &= b - 1;
+        return cell;
+    }
+
+    // Papan simetris terhadap cermin kiri-kanan dan atas-bawah. Empat simetri:
+    // 0 identitas, 1 kiri-kanan, 2 atas-bawah, 3 keduanya; masing-masing kebalikan dirinya sendiri.
+    const int SYMMETRY_COUNT = 4;
+
+    struct SymmetryTable {
+        int8_t cell[SYMMETRY_COUNT][BOARD_CELLS];
+    };
+
+    constexpr SymmetryTable buildSymmetryTable() {
+        SymmetryTable table{};
+        for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+            for (int y = 0; y < BOARD_HEIGHT; y++) {
+                for (int x = 0; x < BOARD_WIDTH; x++) {
+                    int mirroredX = symmetry & 1 ? BOARD_WIDTH - 1 - x : x;
+                    int mirroredY = symmetry & 2 ? BOARD_HEIGHT - 1 - y : y;
+                    table.cell[symmetry][y * BOARD_WIDTH + x] = int8_t(mirroredY * BOARD_WIDTH + mirroredX);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr SymmetryTable SYMMETRY = buildSymmetryTable();
+
+    constexpr bool isSymmetricLayout() {
+        for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+            for (int cell = 0; cell < BOARD_CELLS; cell++) {
+                if (((PLAYABLE_MASK >> cell) & 1) != ((PLAYABLE_MASK >> SYMMETRY.cell[symmetry][cell]) & 1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static_assert(isSymmetricLayout(), "Kunci kanonik membutuhkan papan yang simetris");
+
+    inline Bitboard mirrorBoard(Bitboard board, int symmetry) {
+        if (symmetry == 0) return board;
+        Bitboard mirrored = 0;
+        while (board) mirrored |= Bitboard(1) << SYMMETRY.cell[symmetry][popLowestCell(board)];
+        return mirrored;
+    }
+
     class Position {
     public:
         int x, y;
@@ -15,553 +245,5223 @@
         }
     };
 
-    class Piece {
-    public:
-        string pieceType; 
-        Position position;
+    inline Position cellPosition(int cell) {
+        return Position(cell % BOARD_WIDTH, cell / BOARD_WIDTH);
+    }
+
+    const int8_t NO_CELL = -1;
+
+    // Satu langkah: penempatan (from == NO_CELL), geser, atau lompatan Macan (captured != NO_CELL)
+    struct Move {
+        int8_t from;
+        int8_t to;
+        int8_t captured;
+
+        bool operator==(const Move& other) const {
+            return from == other.from && to == other.to && captured == other.captured;
+        }
+    };
+
+    const Move NO_MOVE = {NO_CELL, NO_CELL, NO_CELL};
+
+    inline int8_t mirrorCell(int8_t cell, int symmetry) {
+        return cell == NO_CELL ? NO_CELL : SYMMETRY.cell[symmetry][cell];
+    }
+
+    inline Move mirrorMove(const Move& move, int symmetry) {
+        return {mirrorCell(move.from, symmetry), mirrorCell(move.to, symmetry), mirrorCell(move.captured, symmetry)};
+    }
+
+    // Batas atas langkah sah: 8 Uwong x 8 tetangga; penempatan paling banyak 37 sel
+    const int MAX_MOVES = 64;
+
+    // Daftar langkah berkapasitas tetap di stack, tanpa alokasi heap
+    struct MoveList {
+        Move moves[MAX_MOVES];
+        int count = 0;
+
+        void add(int8_t from, int8_t to, int8_t captured) {
+            moves[count++] = {from, to, captured};
+        }
+
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        Move* begin() { return moves; }
+        Move* end() { return moves + count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+        Move& operator[](int i) { return moves[i]; }
+        const Move& operator[](int i) const { return moves[i]; }
+    };
+
+    string moveToString(const Move& move) {
+        Position to = cellPosition(move.to);
+        string target = "(" + to_string(to.x) + "," + to_string(to.y) + ")";
+        if (move.from == NO_CELL) return target;
+
+        Position from = cellPosition(move.from);
+        string source = "(" + to_string(from.x) + "," + to_string(from.y) + ")";
+        return source + (move.captured != NO_CELL ? "x" : "-") + target;
+    }
+
+    enum Side : uint8_t {
+        SIDE_MACAN = 0,
+        SIDE_UWONG = 1
+    };
+
+    inline Side opponentOf(Side side) {
+        return side == SIDE_MACAN ? SIDE_UWONG : SIDE_MACAN;
+    }
+
+    inline string sideName(Side side) {
+        return side == SIDE_MACAN ? "macan" : "uwong";
+    }
+
+    // Bobot evaluasi statis, dipakai evaluasi inkremental maupun evaluasi batch
+    const int EVAL_UWONG_PIECE = 100;
+    const int EVAL_UWONG_PAIR = 20;       // per pasangan Uwong bersebelahan, dari kedua sisi
+    const int EVAL_UWONG_CONTACT = 30;    // per pasangan Uwong-Macan bersebelahan
+    const int EVAL_MACAN_THREAT = 1000;   // Macan bisa makan
+    const int EVAL_MACAN_CENTRALITY = 5;
+    const int EVAL_MACAN_CROWDED = 50;    // per Macan yang bersebelahan dengan Uwong
+
+    // Posisi ringkas untuk evaluasi batch: dua bitboard, giliran di bit 63 (tidak dipakai papan)
+    const Bitboard PACKED_UWONG_TO_MOVE = Bitboard(1) << 63;
+
+    struct PackedPosition {
+        Bitboard macans;    // beserta PACKED_UWONG_TO_MOVE
+        Bitboard uwongs;
+    };
+
+    // Masker bitboard untuk evaluasi tanpa iterasi per bidak
+    struct EvalMasks {
+        Bitboard eastLink;                            // sel yang terhubung ke sel (x + 1, y)
+        Bitboard southLink;                           // sel yang terhubung ke sel (x, y + 1)
+        Bitboard centralityPlanes[4];                 // bit ke-b dari CELL_CENTRALITY tiap sel
+        Bitboard jumpSources[DIRECTION_COUNT];        // sel asal lompatan ke arah d
+        int jumpShift[DIRECTION_COUNT];               // pergeseran bit satu langkah ke arah d
+    };
+
+    constexpr EvalMasks buildEvalMasks() {
+        EvalMasks masks{};
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            int x = cell % BOARD_WIDTH;
+            int y = cell / BOARD_WIDTH;
+            if (!isPlayableCell(x, y)) continue;
+
+            Bitboard bit = Bitboard(1) << cell;
+            if (isPlayableCell(x + 1, y)) masks.eastLink |= bit;
+            if (isPlayableCell(x, y + 1)) masks.southLink |= bit;
+            for (int b = 0; b < 4; b++) {
+                if ((CELL_CENTRALITY.value[cell] >> b) & 1) masks.centralityPlanes[b] |= bit;
+            }
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                int dx = DIRECTIONS[d][0];
+                int dy = DIRECTIONS[d][1];
+                if (isPlayableCell(x + dx, y + dy) && isPlayableCell(x + 2 * dx, y + 2 * dy)) {
+                    masks.jumpSources[d] |= bit;
+                }
+            }
+        }
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            masks.jumpShift[d] = DIRECTIONS[d][1] * BOARD_WIDTH + DIRECTIONS[d][0];
+        }
+        return masks;
+    }
+
+    constexpr EvalMasks EVAL_MASKS = buildEvalMasks();
+
+    constexpr bool centralityFitsPlanes() {
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            if (isPlayableCell(cell % BOARD_WIDTH, cell / BOARD_WIDTH) &&
+                (CELL_CENTRALITY.value[cell] < 0 || CELL_CENTRALITY.value[cell] >= 16)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(centralityFitsPlanes(), "Centrality harus muat dalam 4 bit plane");
+
+    inline Bitboard shiftBoard(Bitboard board, int shift) {
+        return shift >= 0 ? board << shift : board >> -shift;
+    }
+
+    // Suku evaluasi statis. Skor dari sudut pandang Macan adalah jumlah
+    // EVAL_TERM_SIGN[t] * EVAL_WEIGHTS[t] * fitur ke-t, sehingga linear terhadap bobot.
+    enum EvalTerm {
+        TERM_UWONG_PIECE,
+        TERM_UWONG_PAIR,
+        TERM_UWONG_CONTACT,
+        TERM_MACAN_THREAT,
+        TERM_MACAN_CENTRALITY,
+        TERM_MACAN_CROWDED,
+        EVAL_TERM_COUNT
+    };
+
+    const int EVAL_WEIGHTS[EVAL_TERM_COUNT] = {
+        EVAL_UWONG_PIECE, EVAL_UWONG_PAIR, EVAL_UWONG_CONTACT,
+        EVAL_MACAN_THREAT, EVAL_MACAN_CENTRALITY, EVAL_MACAN_CROWDED
+    };
+    const int EVAL_TERM_SIGN[EVAL_TERM_COUNT] = {-1, -1, 1, 1, 1, -1};
+    const char* const EVAL_TERM_NAMES[EVAL_TERM_COUNT] = {
+        "EVAL_UWONG_PIECE", "EVAL_UWONG_PAIR", "EVAL_UWONG_CONTACT",
+        "EVAL_MACAN_THREAT", "EVAL_MACAN_CENTRALITY", "EVAL_MACAN_CROWDED"
+    };
+
+    // Nilai fitur tiap suku evaluasi untuk papan macans/uwongs (tanpa bit giliran)
+    inline __attribute__((always_inline)) void evalFeatures(Bitboard macans, Bitboard uwongs, int* features) {
+        Bitboard empty = PLAYABLE_MASK & ~(macans | uwongs);
+        Bitboard east = EVAL_MASKS.eastLink;
+        Bitboard south = EVAL_MASKS.southLink;
+
+        Bitboard nearUwong = ((uwongs >> 1) & east) | ((uwongs & east) << 1) |
+                             ((uwongs >> BOARD_WIDTH) & south) | ((uwongs & south) << BOARD_WIDTH);
+        int centrality = 0;
+        for (int b = 0; b < 4; b++) centrality += popCount(macans & EVAL_MASKS.centralityPlanes[b]) << b;
+
+        Bitboard threats = 0;
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            int shift = EVAL_MASKS.jumpShift[d];
+            Bitboard over = shiftBoard(macans & EVAL_MASKS.jumpSources[d], shift) & uwongs;
+            threats |= shiftBoard(over, shift) & empty;
+        }
+
+        features[TERM_UWONG_PIECE] = popCount(uwongs);
+        features[TERM_UWONG_PAIR] = 2 * (popCount(uwongs & (uwongs >> 1) & east) +
+                                         popCount(uwongs & (uwongs >> BOARD_WIDTH) & south));
+        features[TERM_UWONG_CONTACT] = popCount(macans & (uwongs >> 1) & east) + popCount(uwongs & (macans >> 1) & east) +
+                                       popCount(macans & (uwongs >> BOARD_WIDTH) & south) +
+                                       popCount(uwongs & (macans >> BOARD_WIDTH) & south);
+        features[TERM_MACAN_THREAT] = threats ? 1 : 0;
+        features[TERM_MACAN_CENTRALITY] = centrality;
+        features[TERM_MACAN_CROWDED] = popCount(macans & nearUwong);
+    }
+
+    // Skor statis untuk pemain yang jalan; sama persis dengan MacananGameState::evaluateForSideToMove
+    inline int evaluatePacked(const PackedPosition& position) {
+        int features[EVAL_TERM_COUNT];
+        evalFeatures(position.macans & ~PACKED_UWONG_TO_MOVE, position.uwongs, features);
+        int score = 0;
+        for (int t = 0; t < EVAL_TERM_COUNT; t++) score += EVAL_TERM_SIGN[t] * EVAL_WEIGHTS[t] * features[t];
+        return (position.macans & PACKED_UWONG_TO_MOVE) ? -score : score;
+    }
+
+    typedef void (*BatchEvaluator)(const PackedPosition* positions, int* scores, size_t count);
+
+    void evaluateBatchScalar(const PackedPosition* positions, int* scores, size_t count) {
+        for (size_t i = 0; i < count; i++) scores[i] = evaluatePacked(positions[i]);
+    }
+
+    #ifdef MACANAN_X86
+    // Popcount per lane 64-bit (AVX2 belum punya vpopcntq): tabel nibble lalu jumlah byte
+    __attribute__((target("avx2"))) inline __m256i popCount4(__m256i board) {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(board, nibble));
+        __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(board, 4), nibble));
+        return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+    }
+
+    __attribute__((target("avx2"))) inline __m256i shiftBoard4(__m256i board, int shift) {
+        return shift >= 0 ? _mm256_sll_epi64(board, _mm_cvtsi32_si128(shift))
+                          : _mm256_srl_epi64(board, _mm_cvtsi32_si128(-shift));
+    }
+
+    __attribute__((target("avx2"))) inline __m256i scale4(__m256i counts, int weight) {
+        return _mm256_mul_epu32(counts, _mm256_set1_epi64x(weight));
+    }
+
+    // Empat posisi per iterasi, satu per lane 64-bit; sisanya lewat jalur skalar
+    __attribute__((target("avx2"))) void evaluateBatchAvx2(const PackedPosition* positions, int* scores, size_t count) {
+        const __m256i playable = _mm256_set1_epi64x(int64_t(PLAYABLE_MASK));
+        const __m256i east = _mm256_set1_epi64x(int64_t(EVAL_MASKS.eastLink));
+        const __m256i south = _mm256_set1_epi64x(int64_t(EVAL_MASKS.southLink));
+        const __m256i sideBit = _mm256_set1_epi64x(int64_t(PACKED_UWONG_TO_MOVE));
+        const __m256i zero = _mm256_setzero_si256();
+        // Lane hasil unpack berurutan posisi 0, 2, 1, 3
+        const __m256i laneOrder = _mm256_setr_epi32(0, 4, 2, 6, 0, 0, 0, 0);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions + i));
+            __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions + i + 2));
+            __m256i packedMacans = _mm256_unpacklo_epi64(first, second);
+            __m256i uwongs = _mm256_unpackhi_epi64(first, second);
+            __m256i side = _mm256_cmpeq_epi64(_mm256_and_si256(packedMacans, sideBit), sideBit);
+            __m256i macans = _mm256_andnot_si256(sideBit, packedMacans);
+            __m256i empty = _mm256_andnot_si256(_mm256_or_si256(macans, uwongs), playable);
+
+            __m256i uwongsEast = _mm256_and_si256(_mm256_srli_epi64(uwongs, 1), east);
+            __m256i uwongsSouth = _mm256_and_si256(_mm256_srli_epi64(uwongs, BOARD_WIDTH), south);
+            __m256i macansEast = _mm256_and_si256(_mm256_srli_epi64(macans, 1), east);
+            __m256i macansSouth = _mm256_and_si256(_mm256_srli_epi64(macans, BOARD_WIDTH), south);
+
+            __m256i pairs = _mm256_add_epi64(popCount4(_mm256_and_si256(uwongs, uwongsEast)),
+                                             popCount4(_mm256_and_si256(uwongs, uwongsSouth)));
+            __m256i contacts = _mm256_add_epi64(
+                _mm256_add_epi64(popCount4(_mm256_and_si256(macans, uwongsEast)), popCount4(_mm256_and_si256(uwongs, macansEast))),
+                _mm256_add_epi64(popCount4(_mm256_and_si256(macans, uwongsSouth)), popCount4(_mm256_and_si256(uwongs, macansSouth))));
+            __m256i nearUwong = _mm256_or_si256(
+                _mm256_or_si256(uwongsEast, _mm256_slli_epi64(_mm256_and_si256(uwongs, east), 1)),
+                _mm256_or_si256(uwongsSouth, _mm256_slli_epi64(_mm256_and_si256(uwongs, south), BOARD_WIDTH)));
+
+            __m256i centrality = zero;
+            for (int b = 0; b < 4; b++) {
+                __m256i plane = _mm256_set1_epi64x(int64_t(EVAL_MASKS.centralityPlanes[b]));
+                centrality = _mm256_add_epi64(centrality, shiftBoard4(popCount4(_mm256_and_si256(macans, plane)), b));
+            }
+
+            __m256i threats = zero;
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                int shift = EVAL_MASKS.jumpShift[d];
+                __m256i sources = _mm256_and_si256(macans, _mm256_set1_epi64x(int64_t(EVAL_MASKS.jumpSources[d])));
+                __m256i over = _mm256_and_si256(shiftBoard4(sources, shift), uwongs);
+                threats = _mm256_or_si256(threats, _mm256_and_si256(shiftBoard4(over, shift), empty));
+            }
+            __m256i threatBonus = _mm256_andnot_si256(_mm256_cmpeq_epi64(threats, zero), _mm256_set1_epi64x(EVAL_MACAN_THREAT));
+
+            __m256i macanScore = _mm256_sub_epi64(
+                _mm256_add_epi64(threatBonus, scale4(centrality, EVAL_MACAN_CENTRALITY)),
+                scale4(popCount4(_mm256_and_si256(macans, nearUwong)), EVAL_MACAN_CROWDED));
+            __m256i uwongScore = _mm256_sub_epi64(
+                _mm256_add_epi64(scale4(popCount4(uwongs), EVAL_UWONG_PIECE), scale4(pairs, 2 * EVAL_UWONG_PAIR)),
+                scale4(contacts, EVAL_UWONG_CONTACT));
+            __m256i score = _mm256_sub_epi64(macanScore, uwongScore);
+            score = _mm256_sub_epi64(_mm256_xor_si256(score, side), side);
+
+            __m256i ordered = _mm256_permutevar8x32_epi32(score, laneOrder);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(scores + i), _mm256_castsi256_si128(ordered));
+        }
+        evaluateBatchScalar(positions + i, scores + i, count - i);
+    }
+    #endif
+
+    inline BatchEvaluator selectBatchEvaluator() {
+    #ifdef MACANAN_X86
+        if (__builtin_cpu_supports("avx2")) return evaluateBatchAvx2;
+    #endif
+        return evaluateBatchScalar;
+    }
+
+    // Dipilih sekali saat program mulai, sesuai CPU yang menjalankan
+    const BatchEvaluator BATCH_EVALUATOR = selectBatchEvaluator();
+
+    inline const char* batchEvaluatorName() {
+    #ifdef MACANAN_X86
+        if (BATCH_EVALUATOR == evaluateBatchAvx2) return "avx2";
+    #endif
+        return "scalar";
+    }
+
+    // Evaluasi banyak posisi sekaligus; scores[i] sama dengan evaluatePacked(positions[i])
+    inline void evaluateBatch(const PackedPosition* positions, int* scores, size_t count) {
+        BATCH_EVALUATOR(positions, scores, count);
+    }
+
+    // Evaluator neural (NNUE) opsional: fitur jenis bidak x sel -> akumulator int16 selebar
+    // NNUE_HIDDEN yang diperbarui inkremental -> clipped ReLU -> keluaran int8 per pemain jalan
+    const int NNUE_INPUTS = 2 * BOARD_CELLS;
+    const int NNUE_HIDDEN = 128;
+    const int NNUE_CLIP = 127;              // batas atas clipped ReLU (skala akumulator)
+    const int NNUE_WEIGHT_SCALE = 64;       // skala bobot keluaran int8
+    const int NNUE_OUTPUT_SCALE = 1000;     // satuan evaluasi per satu unit keluaran jaringan
+    const int NNUE_MAX_SCORE = 30000;       // jauh di bawah skor menang pasti
 
-        Piece(string type, Position pos)
-            : pieceType(type), position(pos) {}
+    inline int nnueFeature(Side side, int cell) {
+        return side * BOARD_CELLS + cell;
+    }
+
+    // Tambah/kurangi satu kolom bobot fitur ke akumulator
+    inline void addNnueColumn(int16_t* accumulator, const int16_t* column, int sign) {
+    #ifdef __SSE2__
+        for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+            __m128i* target = reinterpret_cast<__m128i*>(accumulator + i);
+            __m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+            *target = sign > 0 ? _mm_add_epi16(*target, weights) : _mm_sub_epi16(*target, weights);
+        }
+    #else
+        for (int i = 0; i < NNUE_HIDDEN; i++) accumulator[i] = int16_t(accumulator[i] + sign * column[i]);
+    #endif
+    }
+
+    class NnueNetwork;
+
+    // Kapasitas stack undo makeMove/unmakeMove (cukup untuk kedalaman pencarian maksimum)
+    const int UNDO_STACK_SIZE = 256;
+
+    // Aturan permainan yang bisa diatur dari baris perintah; diisi main sebelum mode apa pun berjalan
+    struct GameRules {
+        string describe() const {
+            if (minUwong == 0) return "game ends only when the side to move has no legal move";
+            return "variant: macan also wins when fewer than " + to_string(minUwong) + " uwong remain (--min-uwong)";
+        }
+
+        // Aturan dasar (0): permainan hanya berakhir jika pemain jalan tidak punya langkah sah.
+        // Varian opsional --min-uwong N (misalnya 3): Macan juga menang begitu jumlah Uwong
+        // (di papan + belum ditempatkan) kurang dari N. Varian ini bukan aturan asli dan tidak
+        // mencegah permainan berputar; pengulangan tetap ditangani terpisah (lihat selfplay).
+        // Tablebase mencatat nilai yang dipakai saat dibuat dan hanya dimuat jika nilainya sama.
+        int minUwong;
     };
 
+    const int DEFAULT_MIN_UWONG = 0;
+    GameRules RULES = {DEFAULT_MIN_UWONG};
+
+    const int DEFAULT_SEARCH_DEPTH = 6;
+    const size_t DEFAULT_HASH_MB = 16;
+
+    class AIEngine;
+    struct SearchLimits;
+    struct SearchResult;
+
     class MacananGameState {
     private:
-        const int BOARD_WIDTH = 9; 
-        const int BOARD_HEIGHT = 7; 
-        vector<Piece> pieces;
-        string currentTurn;    
-        int remainingUwong;          
+        Bitboard macanBoard;
+        Bitboard uwongBoard;
+        Side sideToMove;
+        int remainingUwong;    // fase PLACING selama masih ada sisa penempatan
         int remainingMacan;
+        // Zobrist (bidak, giliran, sisa penempatan) untuk posisi yang dicerminkan
+        // dengan tiap simetri; hashKeys[0] adalah hash posisi apa adanya
+        uint64_t hashKeys[SYMMETRY_COUNT];
+
+        // Komponen evaluasi yang diperbarui setiap kali bidak dipasang/dilepas
+        int uwongAdjacentPairs;  // pasangan Uwong bersebelahan, dihitung dari kedua sisi
+        int uwongMacanContacts;  // pasangan Uwong-Macan bersebelahan
+        int macanCentrality;     // jumlah skor posisi semua Macan
         string gameStatus;     
         string winner;          
-        string macanPhase;  // "PLACING" atau "MOVING"
-        string uwongPhase;  // "PLACING" atau "MOVING"
         string humanPlayer;    // "macan" atau "uwong"
         string aiPlayer;       // "macan" atau "uwong"
+        Move undoStack[UNDO_STACK_SIZE];  // langkah yang sudah dijalankan makeMove
+        int undoCount;
 
-        bool playable[7][9] = {
-            {false, false, true,  true,  true,  true,  true,  false, false},
-            {true,  false, true,  true,  true,  true,  true,  false, true },
-            {false, true,  false, false, false, false, false, true,  false},
-            {true,  true,  true,  true,  true,  true,  true,  true,  true },
-            {false, true,  false, false, false, false, false, true,  false},
-            {true,  false, true,  true,  true,  true,  true,  false, true },
-            {false, false, true,  true,  true,  true,  true,  false, false}
-        };
+        // Akumulator lapisan pertama NNUE; hanya dijaga bila network terpasang
+        const NnueNetwork* network;
+        alignas(16) int16_t accumulator[NNUE_HIDDEN];
 
-        // Helper function untuk mengecek apakah ada Uwong yang bisa dimakan
-        bool canEatUwong(const Position& macanPos) const {
-            // Arah gerakan yang mungkin (horizontal, vertikal, dan diagonal)
-            const int directions[8][2] = {
-                {0, 2}, {2, 0}, {0, -2}, {-2, 0},  // horizontal & vertikal
-                {2, 2}, {2, -2}, {-2, 2}, {-2, -2}  // diagonal
-            };
+        // Perbarui akumulator untuk fitur yang dipasang (sign 1) atau dilepas (sign -1)
+        void updateAccumulator(int feature, int sign);
+        void refreshAccumulator();
+
+        Bitboard occupiedBoard() const {
+            return macanBoard | uwongBoard;
+        }
+
+        // XOR kunci yang sama ke hash semua simetri (giliran dan sisa penempatan)
+        void toggleKey(uint64_t key) {
+            for (uint64_t& hashKey : hashKeys) hashKey ^= key;
+        }
 
-            for (const auto& dir : directions) {
-                int midX = macanPos.x + dir[0]/2;
-                int midY = macanPos.y + dir[1]/2;
-                int targetX = macanPos.x + dir[0];
-                int targetY = macanPos.y + dir[1];
+        // Pasang/lepas bidak di cell sambil menjaga hashKeys dan komponen evaluasi
+        void toggleMacan(int cell) {
+            int sign = (macanBoard >> cell) & 1 ? -1 : 1;
+            macanBoard ^= Bitboard(1) << cell;
+            for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+                hashKeys[symmetry] ^= ZOBRIST.macan[SYMMETRY.cell[symmetry][cell]];
+            }
 
-                // Cek apakah posisi target valid
-                if (!isPlayablePosition(targetX, targetY)) continue;
+            uwongMacanContacts += sign * popCount(BOARD_GRAPH.orthogonalNeighbours[cell] & uwongBoard);
+            macanCentrality += sign * CELL_CENTRALITY.value[cell];
+            if (network != nullptr) updateAccumulator(nnueFeature(SIDE_MACAN, cell), sign);
+        }
 
-                // Cek apakah ada Uwong di tengah dan posisi target kosong
-                bool uwongInMiddle = false;
-                bool targetEmpty = true;
+        void toggleUwong(int cell) {
+            int sign = (uwongBoard >> cell) & 1 ? -1 : 1;
+            uwongBoard ^= Bitboard(1) << cell;
+            for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+                hashKeys[symmetry] ^= ZOBRIST.uwong[SYMMETRY.cell[symmetry][cell]];
+            }
 
-                for (const auto& piece : pieces) {
-                    if (piece.position.x == midX && piece.position.y == midY && piece.pieceType == "uwong") {
-                        uwongInMiddle = true;
-                    }
-                    if (piece.position.x == targetX && piece.position.y == targetY) {
-                        targetEmpty = false;
+            Bitboard neighbours = BOARD_GRAPH.orthogonalNeighbours[cell];
+            uwongAdjacentPairs += sign * 2 * popCount(neighbours & uwongBoard);
+            uwongMacanContacts += sign * popCount(neighbours & macanBoard);
+            if (network != nullptr) updateAccumulator(nnueFeature(SIDE_UWONG, cell), sign);
+        }
+
+        void setRemainingMacan(int count) {
+            toggleKey(ZOBRIST.remainingMacan[remainingMacan] ^ ZOBRIST.remainingMacan[count]);
+            remainingMacan = count;
+        }
+
+        void setRemainingUwong(int count) {
+            toggleKey(ZOBRIST.remainingUwong[remainingUwong] ^ ZOBRIST.remainingUwong[count]);
+            remainingUwong = count;
+        }
+
+        Bitboard emptyBoard() const {
+            return PLAYABLE_MASK & ~occupiedBoard();
+        }
+
+        // Lompatan makan untuk setiap Macan di macans
+        void generateJumps(Bitboard macans, MoveList& list) const {
+            Bitboard empty = emptyBoard();
+            while (macans) {
+                int from = popLowestCell(macans);
+                for (int i = 0; i < BOARD_GRAPH.jumpCount[from]; i++) {
+                    const Jump& jump = BOARD_GRAPH.jumps[from][i];
+                    // Uwong di sebelah Macan, lalu sel kosong tepat di belakangnya
+                    if (((uwongBoard >> jump.over) & (empty >> jump.landing) & 1) != 0) {
+                        list.add(int8_t(from), jump.landing, jump.over);
                     }
                 }
+            }
+        }
+
+        // Langkah geser ke tetangga kosong untuk setiap bidak di pieces
+        void generateSteps(Bitboard pieces, MoveList& list) const {
+            Bitboard empty = emptyBoard();
+            while (pieces) {
+                int from = popLowestCell(pieces);
+                for (Bitboard targets = BOARD_GRAPH.neighbours[from] & empty; targets; ) {
+                    list.add(int8_t(from), int8_t(popLowestCell(targets)), NO_CELL);
+                }
+            }
+        }
 
-                if (uwongInMiddle && targetEmpty) return true;
+        // Jumlah lompatan makan yang tersedia bagi macans jika Uwong berada di uwongs
+        static int countJumps(Bitboard macans, Bitboard uwongs) {
+            Bitboard empty = PLAYABLE_MASK & ~(macans | uwongs);
+            int count = 0;
+            while (macans) {
+                int from = popLowestCell(macans);
+                for (int i = 0; i < BOARD_GRAPH.jumpCount[from]; i++) {
+                    const Jump& jump = BOARD_GRAPH.jumps[from][i];
+                    count += int((uwongs >> jump.over) & (empty >> jump.landing) & 1);
+                }
+            }
+            return count;
+        }
+
+        // Helper function untuk mengecek apakah ada Macan di macans yang bisa memakan Uwong
+        bool canEatUwong(Bitboard macans) const {
+            MoveList jumps;
+            generateJumps(macans, jumps);
+            return !jumps.empty();
+        }
+
+        // Pindahkan bidak milik side sesuai move, tanpa validasi dan tanpa ganti giliran
+        void applyPieces(const Move& move, Side side) {
+            if (move.from == NO_CELL) {
+                if (side == SIDE_MACAN) {
+                    toggleMacan(move.to);
+                    setRemainingMacan(remainingMacan - 1);
+                } else {
+                    toggleUwong(move.to);
+                    setRemainingUwong(remainingUwong - 1);
+                }
+            } else if (side == SIDE_MACAN) {
+                toggleMacan(move.from);
+                toggleMacan(move.to);
+                if (move.captured != NO_CELL) toggleUwong(move.captured);
+            } else {
+                toggleUwong(move.from);
+                toggleUwong(move.to);
             }
-            return false;
         }
 
         // Menghitung skor posisi berdasarkan jarak dari tengah
         int calculatePositionScore(const Position& pos) const {
-            // Pusat board
-            const int centerX = BOARD_WIDTH / 2;
-            const int centerY = BOARD_HEIGHT / 2;
-            
             // Semakin dekat ke tengah, semakin tinggi skornya
-            return 10 - (abs(pos.x - centerX) + abs(pos.y - centerY));
+            return centralityScore(pos.x, pos.y);
         }
         
 
         // Helper function untuk mendapatkan semua gerakan yang mungkin dari suatu posisi
         vector<Position> getValidMoves(const Position& pos) const {
             vector<Position> validMoves;
-            
-            // Arah gerakan yang mungkin (horizontal, vertikal, dan diagonal)
-            const int directions[8][2] = {
-                {0, 1}, {1, 0}, {0, -1}, {-1, 0},  // horizontal & vertikal
-                {1, 1}, {1, -1}, {-1, 1}, {-1, -1}  // diagonal
-            };
+            Bitboard fromBit = cellBit(pos.x, pos.y);
+            if (!(fromBit & occupiedBoard())) return validMoves;
 
-            for (const auto& dir : directions) {
-                int newX = pos.x + dir[0];
-                int newY = pos.y + dir[1];
-                
-                // Cek apakah posisi baru valid dan bisa dimainkan
-                if (isPlayablePosition(newX, newY) && !isPositionOccupied(Position(newX, newY))) {
-                    validMoves.emplace_back(newX, newY);
+            MoveList moves;
+            generateMoves((macanBoard & fromBit) ? SIDE_MACAN : SIDE_UWONG, moves);
+            for (const Move& move : moves) {
+                if (move.from == cellIndex(pos.x, pos.y)) {
+                    validMoves.push_back(cellPosition(move.to));
                 }
             }
-
             return validMoves;
         }
 
         // Menghitung skor untuk Uwong
         int evaluateUwongPosition() const {
             int score = 0;
-            vector<Position> uwongPositions;
-            vector<Position> macanPositions;
 
-            // Kumpulkan posisi semua piece
-            for (const auto& piece : pieces) {
-                if (piece.pieceType == "uwong") {
-                    uwongPositions.push_back(piece.position);
-                } else {
-                    macanPositions.push_back(piece.position);
-                }
+            // Bonus untuk jumlah Uwong yang tersisa
+            score += popCount(uwongBoard) * EVAL_UWONG_PIECE;
+
+            // Bonus untuk formasi berkelompok (saling melindungi), dihitung dari kedua sisi pasangan
+            score += uwongAdjacentPairs * EVAL_UWONG_PAIR;
+
+            // Penalti untuk Uwong yang terlalu dekat dengan Macan
+            score -= uwongMacanContacts * EVAL_UWONG_CONTACT;
+
+            return score;
+        }
+
+        // Menghitung skor untuk Macan
+        int evaluateMacanPosition() const {
+            int score = 0;
+
+            // Bonus tinggi jika bisa memakan Uwong
+            if (canEatUwong(macanBoard)) {
+                score += EVAL_MACAN_THREAT;
+            }
+
+            // Bonus untuk posisi strategis di tengah
+            score += macanCentrality * EVAL_MACAN_CENTRALITY;
+
+            // Penalti untuk setiap Macan yang terlalu dekat dengan Uwong
+            for (Bitboard macans = macanBoard; macans; ) {
+                if (BOARD_GRAPH.orthogonalNeighbours[popLowestCell(macans)] & uwongBoard) {
+                    score -= EVAL_MACAN_CROWDED;
+                }
+            }
+
+            return score;
+        }
+
+    public:
+        MacananGameState()
+            : macanBoard(0),
+            uwongBoard(0),
+            sideToMove(SIDE_MACAN),
+            remainingUwong(UWONG_COUNT),
+            remainingMacan(MACAN_COUNT),
+            uwongAdjacentPairs(0),
+            uwongMacanContacts(0),
+            macanCentrality(0),
+            winner(""),
+            humanPlayer(""),
+            aiPlayer(""),
+            undoCount(0),
+            network(nullptr)
+        {
+            resetHashKeys();
+        }
+
+        // Hash posisi yang dicerminkan dengan symmetry, dihitung ulang dari nol;
+        // hashKeys[symmetry] harus selalu sama dengan ini
+        uint64_t computeHashKey(int symmetry = 0) const {
+            uint64_t key = ZOBRIST.remainingMacan[remainingMacan] ^ ZOBRIST.remainingUwong[remainingUwong];
+            for (Bitboard macans = mirrorBoard(macanBoard, symmetry); macans; ) {
+                key ^= ZOBRIST.macan[popLowestCell(macans)];
+            }
+            for (Bitboard uwongs = mirrorBoard(uwongBoard, symmetry); uwongs; ) {
+                key ^= ZOBRIST.uwong[popLowestCell(uwongs)];
+            }
+            if (sideToMove == SIDE_UWONG) key ^= ZOBRIST.uwongToMove;
+            return key;
+        }
+
+        void resetHashKeys() {
+            for (int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+                hashKeys[symmetry] = computeHashKey(symmetry);
+            }
+        }
+
+        uint64_t getHashKey(int symmetry = 0) const {
+            return hashKeys[symmetry];
+        }
+
+        // Simetri yang membawa posisi ini ke wakil kanoniknya (hash terkecil).
+        // Posisi yang saling cermin punya kunci kanonik yang sama; langkah disimpan
+        // dalam bingkai kanonik dengan mirrorMove(move, symmetry) dan dibalik dengan cara yang sama.
+        int getCanonicalSymmetry() const {
+            int best = 0;
+            for (int symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+                if (hashKeys[symmetry] < hashKeys[best]) best = symmetry;
+            }
+            return best;
+        }
+
+        uint64_t getCanonicalKey() const {
+            return hashKeys[getCanonicalSymmetry()];
+        }
+
+        // Posisi sebagai teks: 7 baris dipisah '/', tiap baris 9 karakter
+        // ('M' Macan, 'U' Uwong, '.' kosong, '-' tidak bisa dimainkan), lalu
+        // giliran (m/u) dan sisa penempatan Macan dan Uwong. Contoh posisi awal:
+        // --.....--/.-.....-./-.-----.-/........./-.-----.-/.-.....-./--.....-- m 2 8
+        string toPositionString() const {
+            string text;
+            for (int y = 0; y < BOARD_HEIGHT; y++) {
+                if (y > 0) text += '/';
+                for (int x = 0; x < BOARD_WIDTH; x++) {
+                    Bitboard bit = cellBit(x, y);
+                    text += (macanBoard & bit) ? 'M' : (uwongBoard & bit) ? 'U'
+                          : (PLAYABLE_MASK & bit) ? '.' : '-';
+                }
+            }
+            text += sideToMove == SIDE_MACAN ? " m " : " u ";
+            text += to_string(remainingMacan) + " " + to_string(remainingUwong);
+            return text;
+        }
+
+        // Kebalikan toPositionString; false (posisi tidak berubah) jika teks tidak sah
+        bool setPosition(const string& text) {
+            Bitboard macans = 0, uwongs = 0;
+            size_t index = 0;
+            for (int y = 0; y < BOARD_HEIGHT; y++) {
+                if (y > 0 && (index >= text.size() || text[index++] != '/')) return false;
+                for (int x = 0; x < BOARD_WIDTH; x++, index++) {
+                    if (index >= text.size()) return false;
+                    char c = text[index];
+                    bool playable = isPlayablePosition(x, y);
+                    if (c == '-' && !playable) continue;
+                    if (!playable) return false;
+
+                    if (c == 'M') macans |= cellBit(x, y);
+                    else if (c == 'U') uwongs |= cellBit(x, y);
+                    else if (c != '.') return false;
+                }
+            }
+
+            char side = 0;
+            int macanLeft = -1, uwongLeft = -1;
+            if (sscanf(text.c_str() + index, " %c %d %d", &side, &macanLeft, &uwongLeft) != 3) return false;
+            if (side != 'm' && side != 'u') return false;
+            if (macanLeft < 0 || popCount(macans) + macanLeft != MACAN_COUNT) return false;
+            if (uwongLeft < 0 || popCount(uwongs) + uwongLeft > UWONG_COUNT) return false;
+
+            setPieces(macans, uwongs, side == 'm' ? SIDE_MACAN : SIDE_UWONG, macanLeft, uwongLeft);
+            return true;
+        }
+
+        // Susun posisi langsung dari bitboard (tanpa validasi); riwayat undo dikosongkan
+        void setPieces(Bitboard macans, Bitboard uwongs, Side side, int macanLeft, int uwongLeft) {
+            macanBoard = 0;
+            uwongBoard = 0;
+            uwongAdjacentPairs = 0;
+            uwongMacanContacts = 0;
+            macanCentrality = 0;
+            for (Bitboard cells = macans; cells; ) toggleMacan(popLowestCell(cells));
+            for (Bitboard cells = uwongs; cells; ) toggleUwong(popLowestCell(cells));
+
+            sideToMove = side;
+            remainingMacan = macanLeft;
+            remainingUwong = uwongLeft;
+            undoCount = 0;
+            resetHashKeys();
+            if (network != nullptr) refreshAccumulator();
+        }
+
+        // Pasang evaluator NNUE (nullptr kembali ke evaluasi buatan tangan); akumulator dihitung ulang
+        void setNetwork(const NnueNetwork* nnue) {
+            network = nnue;
+            if (network != nullptr) refreshAccumulator();
+        }
+
+        // Posisi ringkas untuk evaluateBatch
+        PackedPosition pack() const {
+            return {macanBoard | (sideToMove == SIDE_UWONG ? PACKED_UWONG_TO_MOVE : 0), uwongBoard};
+        }
+
+        Bitboard getMacanBoard() const {
+            return macanBoard;
+        }
+
+        Bitboard getUwongBoard() const {
+            return uwongBoard;
+        }
+
+        int getRemainingMacan() const {
+            return remainingMacan;
+        }
+
+        int getRemainingUwong() const {
+            return remainingUwong;
+        }
+
+        void setPlayers(const string& human) {
+            humanPlayer = human;
+            aiPlayer = (human == "macan") ? "uwong" : "macan";
+        }
+
+        bool isAITurn() const {
+            return sideName(sideToMove) == aiPlayer;
+        }
+
+        // Evaluasi board dari sudut pandang player
+        int evaluateFor(Side player) const {
+            if (player == SIDE_MACAN) {
+                return evaluateMacanPosition() - evaluateUwongPosition();
+            } else {
+                return evaluateUwongPosition() - evaluateMacanPosition();
+            }
+        }
+
+        // Evaluasi board untuk AI
+        int evaluateBoard() const {
+            return evaluateFor(aiPlayer == "macan" ? SIDE_MACAN : SIDE_UWONG);
+        }
+
+        // Evaluasi board untuk pemain yang sedang jalan (dipakai negamax)
+        int evaluateForSideToMove() const {
+            return network != nullptr ? evaluateNetwork() : evaluateFor(sideToMove);
+        }
+
+        // Evaluasi NNUE untuk pemain yang sedang jalan (hanya bila network terpasang)
+        int evaluateNetwork() const;
+
+        // AI membuat gerakan dalam batas limits (definisi setelah AIEngine)
+        SearchResult makeAIMove(AIEngine& engine, const SearchLimits& limits);
+
+        // Mainkan langkah hasil pencarian yang sudah ada (misalnya dari pondering)
+        void playAIMove(const SearchResult& result, double milliseconds);
+
+        bool isUwongDefeated() const {
+            return popCount(uwongBoard) + remainingUwong < RULES.minUwong;
+        }
+
+        // Satu lompatan lagi membuat Uwong kurang dari RULES.minUwong
+        bool isLastCapture() const {
+            return popCount(uwongBoard) + remainingUwong - 1 < RULES.minUwong;
+        }
+
+        bool isPlacing(Side side) const {
+            return (side == SIDE_MACAN ? remainingMacan : remainingUwong) > 0;
+        }
+
+        // Semua langkah sah untuk side: satu-satunya tempat aturan gerak ditulis.
+        // Lompatan makan selalu di depan agar pencarian bisa mencobanya lebih dulu.
+        void generateMoves(Side side, MoveList& list) const {
+            list.count = 0;
+
+            if (isPlacing(side)) {
+                for (Bitboard targets = emptyBoard(); targets; ) {
+                    list.add(NO_CELL, int8_t(popLowestCell(targets)), NO_CELL);
+                }
+                return;
+            }
+
+            // Hanya Macan yang bisa memakan dengan melompati Uwong
+            if (side == SIDE_MACAN) {
+                generateJumps(macanBoard, list);
+                generateSteps(macanBoard, list);
+            } else {
+                generateSteps(uwongBoard, list);
+            }
+        }
+
+        // Semua langkah sah untuk pemain yang sedang jalan
+        void generateMoves(MoveList& list) const {
+            generateMoves(sideToMove, list);
+        }
+
+        // Langkah taktis untuk quiescence search: lompatan makan jika Macan jalan, atau
+        // langkah Uwong (geser/penempatan) yang mengurangi jumlah lompatan Macan yang mengancam
+        void generateTacticalMoves(MoveList& list) const {
+            list.count = 0;
+            if (isPlacing(SIDE_MACAN)) return;  // Macan belum bisa melompat
+
+            if (sideToMove == SIDE_MACAN) {
+                generateJumps(macanBoard, list);
+                return;
+            }
+
+            int threats = countJumps(macanBoard, uwongBoard);
+            if (threats == 0) return;
+            MoveList moves;
+            generateMoves(SIDE_UWONG, moves);
+            for (const Move& move : moves) {
+                Bitboard uwongs = uwongBoard | (Bitboard(1) << move.to);
+                if (move.from != NO_CELL) uwongs ^= Bitboard(1) << move.from;
+                if (countJumps(macanBoard, uwongs) < threats) list.add(move.from, move.to, move.captured);
+            }
+        }
+
+        // Kebalikan langkah geser untuk analisis mundur (tablebase): langkah geser
+        // lawan yang bisa menghasilkan posisi ini. Move{from, to} berarti bidak di to
+        // tadinya berada di from. Lompatan tidak termasuk karena mengubah jumlah Uwong.
+        void generateRetroSteps(MoveList& list) const {
+            list.count = 0;
+            Bitboard empty = emptyBoard();
+            for (Bitboard pieces = sideToMove == SIDE_MACAN ? uwongBoard : macanBoard; pieces; ) {
+                int to = popLowestCell(pieces);
+                for (Bitboard sources = BOARD_GRAPH.neighbours[to] & empty; sources; ) {
+                    list.add(int8_t(popLowestCell(sources)), int8_t(to), NO_CELL);
+                }
+            }
+        }
+
+        // Jalankan langkah dari generateMoves lalu ganti giliran; tanpa output dan tanpa alokasi
+        void makeMove(const Move& move) {
+            undoStack[undoCount++] = move;
+            applyPieces(move, sideToMove);
+            switchTurn();
+        }
+
+        // Riwayat makeMove dilupakan; posisi saat ini menjadi dasar stack undo
+        void clearUndoStack() {
+            undoCount = 0;
+        }
+
+        // Batalkan makeMove terakhir, termasuk Uwong yang dimakan dan perubahan fase
+        void unmakeMove() {
+            const Move& move = undoStack[--undoCount];
+            switchTurn();
+
+            // Toggle adalah kebalikan dirinya sendiri, termasuk untuk hash
+            if (move.from == NO_CELL) {
+                if (sideToMove == SIDE_MACAN) {
+                    toggleMacan(move.to);
+                    setRemainingMacan(remainingMacan + 1);
+                } else {
+                    toggleUwong(move.to);
+                    setRemainingUwong(remainingUwong + 1);
+                }
+            } else if (sideToMove == SIDE_MACAN) {
+                toggleMacan(move.to);
+                toggleMacan(move.from);
+                if (move.captured != NO_CELL) toggleUwong(move.captured);
+            } else {
+                toggleUwong(move.to);
+                toggleUwong(move.from);
+            }
+        }
+
+        // Pemenang pada posisi ini, atau "" jika permainan belum selesai
+        string findWinner() const {
+            if (isUwongDefeated()) return "macan";
+            // Pemain yang tidak punya langkah sah kalah
+            MoveList moves;
+            generateMoves(moves);
+            if (moves.empty()) {
+                return sideName(opponentOf(sideToMove));
+            }
+            return "";
+        }
+
+        // Cek kondisi menang; mengisi gameStatus dan winner bila permainan selesai
+        bool checkGameOver() {
+            winner = findWinner();
+            gameStatus = winner.empty() ? "PLAYING" : "FINISHED";
+            return !winner.empty();
+        }
+
+        string getWinner() const {
+            return winner;
+        }
+
+        string getPhaseName(Side side) const {
+            return isPlacing(side) ? "PLACING" : "MOVING";
+        }
+
+        string getGamePhase() const {
+            return getPhaseName(sideToMove);
+        }
+
+        bool canMove(const string& playerType) const {
+            if (playerType == "macan") {
+                return !isPlacing(SIDE_MACAN);
+            } else {  // uwong
+                return !isPlacing(SIDE_UWONG);
+            }
+        }
+
+        bool addPiece(const string& pieceType, int x, int y) {
+            // Cek apakah pemain sudah dalam fase MOVING
+            if ((pieceType == "macan" && !isPlacing(SIDE_MACAN)) ||
+                (pieceType == "uwong" && !isPlacing(SIDE_UWONG))) {
+                cout << "Cannot place pieces after completing placement phase!" << endl;
+                return false;
+            }
+
+            bool valid = false;
+            if (!isPlayablePosition(x, y)) {
+                cout << "Invalid position! (" << x << ", " << y << ") is not playable." << endl;
+                return valid;
+            }
+
+            Position newPos(x, y);
+            if (isPositionOccupied(newPos)) {
+                cout << "Position already occupied at (" << x << ", " << y << ")." << endl;
+                return valid;
+            }
+
+            Move placement = {NO_CELL, int8_t(cellIndex(x, y)), NO_CELL};
+            if (pieceType == "uwong" && remainingUwong > 0) {
+                applyPieces(placement, SIDE_UWONG);
+                valid = true;
+                
+                // Check if Uwong placement is complete
+                if (remainingUwong == 0) {
+                    cout << "Uwong placement complete. Uwong can now move!" << endl;
+                }
+            } else if (pieceType == "macan" && remainingMacan > 0) {
+                applyPieces(placement, SIDE_MACAN);
+                valid = true;
+                
+                // Check if Macan placement is complete
+                if (remainingMacan == 0) {
+                    cout << "Macan placement complete. Macan can now move!" << endl;
+                }
+            }
+
+            return valid;
+        }
+
+        bool isPlayablePosition(int x, int y) const {
+            return (cellBit(x, y) & PLAYABLE_MASK) != 0;
+        }
+
+        bool isPositionOccupied(const Position& pos) const {
+            return (cellBit(pos.x, pos.y) & occupiedBoard()) != 0;
+        }
+
+        void printBoard() const {
+            char board[BOARD_HEIGHT][BOARD_WIDTH] = {
+                {' ', ' ', '.', '.', '.', '.', '.', ' ', ' '},
+                {'.', ' ', '.', '.', '.', '.', '.', ' ', '.'},
+                {' ', '.', ' ', ' ', ' ', ' ', ' ', '.', ' '},
+                {'.', '.', '.', '.', '.', '.', '.', '.', '.'},
+                {' ', '.', ' ', ' ', ' ', ' ', ' ', '.', ' '},
+                {'.', ' ', '.', '.', '.', '.', '.', ' ', '.'},
+                {' ', ' ', '.', '.', '.', '.', '.', ' ', ' '}
+            };
+
+            for (Bitboard macans = macanBoard; macans; ) {
+                int cell = popLowestCell(macans);
+                board[cell / BOARD_WIDTH][cell % BOARD_WIDTH] = 'M';
+            }
+            for (Bitboard uwongs = uwongBoard; uwongs; ) {
+                int cell = popLowestCell(uwongs);
+                board[cell / BOARD_WIDTH][cell % BOARD_WIDTH] = 'U';
+            }
+            for (int y = 0; y < BOARD_HEIGHT; y++) {
+                for (int x = 0; x < BOARD_WIDTH; x++) {
+                    if(board[y][x]=='.'){
+                        cout<<"("<<x<<","<<y<<")";
+                    }else if(board[y][x]==' '){
+                        cout<<"     ";
+                    }else{
+                        cout <<board[y][x] <<"("<<x<<","<<y<<")";
+                    }
+                }
+                cout << endl;
+            }
+        }
+
+        void switchTurn() {
+            sideToMove = opponentOf(sideToMove);
+            toggleKey(ZOBRIST.uwongToMove);
+        }
+
+        string getCurrentTurn() const {
+            return sideName(sideToMove);
+        }
+
+        Side getSideToMove() const {
+            return sideToMove;
+        }
+        
+        
+
+        int evaluatePosition() {
+            return evaluateMacanPosition();
+        }
+
+        bool movePiece(const Position& from, const Position& to) {
+            // Cek apakah pemain sudah bisa bergerak
+            Bitboard fromBit = cellBit(from.x, from.y);
+            string currentPieceType = "";
+            if (macanBoard & fromBit) {
+                currentPieceType = "macan";
+            } else if (uwongBoard & fromBit) {
+                currentPieceType = "uwong";
+            }
+
+            if (currentPieceType == "macan" && isPlacing(SIDE_MACAN)) {
+                cout << "Macan must complete placement phase first!" << endl;
+                return false;
+            } else if (currentPieceType == "uwong" && isPlacing(SIDE_UWONG)) {
+                cout << "Uwong must complete placement phase first!" << endl;
+                return false;
+            }
+
+            // Cek apakah ada pion di posisi awal
+            if (currentPieceType.empty()) {
+                cout << "No piece at starting position!" << endl;
+                return false;
+            }
+
+            // Cek apakah gerakan valid (termasuk gerakan memakan untuk Macan)
+            Side side = (currentPieceType == "macan") ? SIDE_MACAN : SIDE_UWONG;
+            MoveList moves;
+            generateMoves(side, moves);
+            for (const Move& move : moves) {
+                if (move.from == cellIndex(from.x, from.y) && cellPosition(move.to) == to) {
+                    // Lakukan gerakan
+                    applyPieces(move, side);
+                    return true;
+                }
+            }
+
+            cout << "Invalid move!" << endl;
+            return false;
+        }
+
+        // Helper function untuk menampilkan gerakan yang mungkin
+        void showPossibleMoves(const Position& pos) const {
+            vector<Position> moves = getValidMoves(pos);
+            cout << "Possible moves from (" << pos.x << "," << pos.y << "):" << endl;
+            for (const auto& move : moves) {
+                cout << "-> (" << move.x << "," << move.y << ")" << endl;
+            }
+        }
+
+        // Helper function untuk menampilkan status fase
+        void printGameStatus() const {
+            cout << "Current turn: " << getCurrentTurn() << endl;
+            cout << "Macan phase: " << getPhaseName(SIDE_MACAN) << 
+                " (Remaining: " << remainingMacan << ")" << endl;
+            cout << "Uwong phase: " << getPhaseName(SIDE_UWONG) << 
+                " (Remaining: " << remainingUwong << ")" << endl;
+        }
+
+    };
+
+    double elapsedMilliseconds(chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Berkas yang dipetakan ke memori (hanya baca)
+    class MappedFile {
+    private:
+        const uint8_t* bytes;
+        size_t length;
+    #ifdef _WIN32
+        HANDLE fileHandle;
+        HANDLE mappingHandle;
+    #endif
+
+    public:
+        MappedFile() : bytes(nullptr), length(0) {}
+
+        ~MappedFile() {
+            close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const string& path) {
+            close();
+    #ifdef _WIN32
+            fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER fileSize;
+            GetFileSizeEx(fileHandle, &fileSize);
+            mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle == nullptr) {
+                CloseHandle(fileHandle);
+                return false;
+            }
+            bytes = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            if (bytes == nullptr) {
+                CloseHandle(mappingHandle);
+                CloseHandle(fileHandle);
+                return false;
+            }
+            length = size_t(fileSize.QuadPart);
+    #else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat info;
+            if (fstat(fd, &info) != 0 || info.st_size == 0) {
+                ::close(fd);
+                return false;
+            }
+            void* mapped = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED) return false;
+            bytes = static_cast<const uint8_t*>(mapped);
+            length = size_t(info.st_size);
+    #endif
+            return true;
+        }
+
+        void close() {
+            if (bytes == nullptr) return;
+    #ifdef _WIN32
+            UnmapViewOfFile(bytes);
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+    #else
+            munmap(const_cast<uint8_t*>(bytes), length);
+    #endif
+            bytes = nullptr;
+            length = 0;
+        }
+
+        const uint8_t* data() const {
+            return bytes;
+        }
+
+        size_t size() const {
+            return length;
+        }
+    };
+
+    constexpr int countCells(Bitboard b) {
+        int count = 0;
+        for (; b; b &= b - 1) count++;
+        return count;
+    }
+
+    const int PLAYABLE_CELL_COUNT = countCells(PLAYABLE_MASK);
+
+    // Nomor urut sel yang bisa dimainkan (0..36), dipakai untuk menomori posisi tablebase
+    struct PlayableOrder {
+        int8_t cellOf[BOARD_CELLS];   // nomor urut -> sel
+        int8_t orderOf[BOARD_CELLS];  // sel -> nomor urut, -1 jika tidak bisa dimainkan
+    };
+
+    constexpr PlayableOrder buildPlayableOrder() {
+        PlayableOrder order{};
+        int next = 0;
+        for (int cell = 0; cell < BOARD_CELLS; cell++) {
+            order.orderOf[cell] = -1;
+            if ((PLAYABLE_MASK >> cell) & 1) {
+                order.cellOf[next] = int8_t(cell);
+                order.orderOf[cell] = int8_t(next++);
+            }
+        }
+        return order;
+    }
+
+    constexpr PlayableOrder PLAYABLE_ORDER = buildPlayableOrder();
+
+    // Koefisien binomial C(n, k) untuk n <= 37 dan k <= UWONG_COUNT
+    struct BinomialTable {
+        uint32_t value[PLAYABLE_CELL_COUNT + 1][UWONG_COUNT + 1];
+    };
+
+    constexpr BinomialTable buildBinomialTable() {
+        BinomialTable table{};
+        for (int n = 0; n <= PLAYABLE_CELL_COUNT; n++) {
+            table.value[n][0] = 1;
+            for (int k = 1; k <= UWONG_COUNT && k <= n; k++) {
+                table.value[n][k] = table.value[n - 1][k - 1] + (k < n ? table.value[n - 1][k] : 0);
+            }
+        }
+        return table;
+    }
+
+    constexpr BinomialTable BINOMIAL = buildBinomialTable();
+
+    static_assert(MACAN_COUNT == 2, "Penomoran tablebase mengasumsikan tepat dua Macan");
+
+    // Pasangan Macan dengan nomor urut a < b bernomor C(b, 2) + a
+    const int MACAN_PAIR_COUNT = PLAYABLE_CELL_COUNT * (PLAYABLE_CELL_COUNT - 1) / 2;
+
+    constexpr int macanPairNumber(int a, int b) {
+        return a < b ? b * (b - 1) / 2 + a : a * (a - 1) / 2 + b;
+    }
+
+    // Kelas pasangan Macan di bawah simetri papan. Wakil kelas adalah nomor pasangan
+    // terkecil; tablebase hanya menyimpan posisi yang pasangan Macannya sudah wakil.
+    struct MacanPairClasses {
+        int16_t classOf[MACAN_PAIR_COUNT];         // nomor pasangan -> kelas
+        int8_t symmetryOf[MACAN_PAIR_COUNT];       // simetri yang membawa pasangan ke wakilnya
+        int16_t representative[MACAN_PAIR_COUNT]; // kelas -> nomor pasangan wakil
+        uint8_t stabilizer[MACAN_PAIR_COUNT];     // kelas -> bit simetri lain yang tidak mengubah wakilnya
+        int count;
+    };
+
+    constexpr MacanPairClasses buildMacanPairClasses() {
+        MacanPairClasses classes{};
+        for (int b = 1; b < PLAYABLE_CELL_COUNT; b++) {
+            for (int a = 0; a < b; a++) {
+                int pair = macanPairNumber(a, b);
+                int best = pair, bestSymmetry = 0;
+                for (int symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+                    int mirroredA = PLAYABLE_ORDER.orderOf[SYMMETRY.cell[symmetry][PLAYABLE_ORDER.cellOf[a]]];
+                    int mirroredB = PLAYABLE_ORDER.orderOf[SYMMETRY.cell[symmetry][PLAYABLE_ORDER.cellOf[b]]];
+                    int mirrored = macanPairNumber(mirroredA, mirroredB);
+                    if (mirrored < best) {
+                        best = mirrored;
+                        bestSymmetry = symmetry;
+                    }
+                }
+                classes.symmetryOf[pair] = int8_t(bestSymmetry);
+                if (best == pair) {
+                    for (int symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+                        int mirroredA = PLAYABLE_ORDER.orderOf[SYMMETRY.cell[symmetry][PLAYABLE_ORDER.cellOf[a]]];
+                        int mirroredB = PLAYABLE_ORDER.orderOf[SYMMETRY.cell[symmetry][PLAYABLE_ORDER.cellOf[b]]];
+                        if (macanPairNumber(mirroredA, mirroredB) == pair) {
+                            classes.stabilizer[classes.count] |= uint8_t(1 << symmetry);
+                        }
+                    }
+                    classes.representative[classes.count] = int16_t(pair);
+                    classes.classOf[pair] = int16_t(classes.count++);
+                } else {
+                    classes.classOf[pair] = classes.classOf[best];
+                }
+            }
+        }
+        return classes;
+    }
+
+    constexpr MacanPairClasses MACAN_PAIR_CLASSES = buildMacanPairClasses();
+
+    // Penomoran posisi fase MOVING (semua bidak sudah ditempatkan) dengan uwongCount Uwong:
+    // ((kelas pasangan Macan * himpunan Uwong) + himpunan Uwong) * 2 + giliran, memakai
+    // sistem bilangan kombinatorial atas nomor urut sel yang bisa dimainkan. Posisi
+    // dicerminkan dulu sehingga pasangan Macannya menjadi wakil kelas (sekitar 4x lebih kecil);
+    // jika wakil itu simetris, dipilih cermin dengan nomor himpunan Uwong terkecil, sehingga
+    // setiap kelas posisi punya tepat satu indeks.
+    struct TablebaseIndex {
+        // Nomor urut Uwong dirapatkan dengan melewati dua sel Macan a < b
+        static uint64_t uwongSetNumber(Bitboard uwongs, int a, int b) {
+            uint64_t set = 0;
+            for (int i = 1; uwongs; i++) {
+                int order = PLAYABLE_ORDER.orderOf[popLowestCell(uwongs)];
+                set += BINOMIAL.value[order - (order > a) - (order > b)][i];
+            }
+            return set;
+        }
+
+        static void pairOrders(int pair, int& a, int& b) {
+            b = 1;
+            while (macanPairNumber(0, b + 1) <= pair) b++;
+            a = pair - macanPairNumber(0, b);
+        }
+
+        static uint64_t macanPairCount() {
+            return uint64_t(MACAN_PAIR_CLASSES.count);
+        }
+
+        static uint64_t uwongSetCount(int uwongCount) {
+            return BINOMIAL.value[PLAYABLE_CELL_COUNT - MACAN_COUNT][uwongCount];
+        }
+
+        static uint64_t size(int uwongCount) {
+            return macanPairCount() * uwongSetCount(uwongCount) * 2;
+        }
+
+        static uint64_t encode(Bitboard macans, Bitboard uwongs, Side side, int uwongCount) {
+            Bitboard cells = macans;
+            int a = PLAYABLE_ORDER.orderOf[popLowestCell(cells)];
+            int b = PLAYABLE_ORDER.orderOf[popLowestCell(cells)];
+            int pair = macanPairNumber(a, b);
+            int symmetry = MACAN_PAIR_CLASSES.symmetryOf[pair];
+            int pairClass = MACAN_PAIR_CLASSES.classOf[pair];
+            if (symmetry != 0) {
+                uwongs = mirrorBoard(uwongs, symmetry);
+                pairOrders(MACAN_PAIR_CLASSES.representative[pairClass], a, b);
+            }
+
+            uint64_t set = uwongSetNumber(uwongs, a, b);
+            for (uint8_t others = MACAN_PAIR_CLASSES.stabilizer[pairClass]; others; others &= others - 1) {
+                set = min(set, uwongSetNumber(mirrorBoard(uwongs, __builtin_ctz(others)), a, b));
+            }
+            return (uint64_t(pairClass) * uwongSetCount(uwongCount) + set) * 2 + side;
+        }
+
+        static void decode(uint64_t index, int uwongCount, Bitboard& macans, Bitboard& uwongs, Side& side) {
+            side = Side(index & 1);
+            index >>= 1;
+            uint64_t set = index % uwongSetCount(uwongCount);
+            int a, b;
+            pairOrders(MACAN_PAIR_CLASSES.representative[index / uwongSetCount(uwongCount)], a, b);
+            macans = (Bitboard(1) << PLAYABLE_ORDER.cellOf[a]) | (Bitboard(1) << PLAYABLE_ORDER.cellOf[b]);
+
+            uwongs = 0;
+            int rank = PLAYABLE_CELL_COUNT - MACAN_COUNT - 1;
+            for (int i = uwongCount; i >= 1; i--, rank--) {
+                while (BINOMIAL.value[rank][i] > set) rank--;
+                set -= BINOMIAL.value[rank][i];
+                int order = rank;
+                if (order >= a) order++;
+                if (order >= b) order++;
+                uwongs |= Bitboard(1) << PLAYABLE_ORDER.cellOf[order];
+            }
+        }
+    };
+
+    // Nilai entri tablebase: jarak ke akhir permainan (DTM) dalam ply, 0..254.
+    // Ganjil berarti pemain jalan menang, genap berarti kalah; 255 berarti seri.
+    const uint8_t TB_DRAW = 255;
+    const uint8_t TB_MAX_DISTANCE = 254;
+
+    struct TablebaseHeader {
+        char magic[4];                      // "MCTB"
+        uint32_t version;
+        uint32_t minUwong;
+        uint32_t maxUwong;
+        uint64_t offset[UWONG_COUNT + 1];   // letak tabel tiap jumlah Uwong dalam berkas
+    };
+
+    const uint32_t TABLEBASE_VERSION = 2;
+    const string DEFAULT_TABLEBASE_FILE = "macanan.tb";
+
+    // Tablebase akhir permainan fase MOVING, dibaca lewat memory map
+    class EndgameTablebase {
+    private:
+        MappedFile file;
+        const uint8_t* tables[UWONG_COUNT + 1];
+        int minUwong;
+        int maxUwong;
+
+    public:
+        EndgameTablebase() : tables(), minUwong(0), maxUwong(-1) {}
+
+        bool load(const string& path) {
+            maxUwong = -1;
+            if (!file.open(path) || file.size() < sizeof(TablebaseHeader)) return false;
+
+            TablebaseHeader header;
+            memcpy(&header, file.data(), sizeof(header));
+            // Tabel terkecil selalu dibuat pada batas RULES.minUwong; aturan lain memberi nilai berbeda
+            if (memcmp(header.magic, "MCTB", 4) != 0 || header.version != TABLEBASE_VERSION ||
+                header.minUwong != uint32_t(RULES.minUwong) || header.minUwong > header.maxUwong ||
+                header.maxUwong > UWONG_COUNT) {
+                file.close();
+                return false;
+            }
+            for (uint32_t k = header.minUwong; k <= header.maxUwong; k++) {
+                if (header.offset[k] + TablebaseIndex::size(k) > file.size()) {
+                    file.close();
+                    return false;
+                }
+                tables[k] = file.data() + header.offset[k];
+            }
+            minUwong = int(header.minUwong);
+            maxUwong = int(header.maxUwong);
+            return true;
+        }
+
+        bool isLoaded() const {
+            return maxUwong >= 0;
+        }
+
+        int getMaxUwong() const {
+            return maxUwong;
+        }
+
+        // Posisi ada di tablebase jika semua bidak sudah ditempatkan dan jumlah Uwong tercakup
+        bool covers(const MacananGameState& state) const {
+            if (state.getRemainingMacan() != 0 || state.getRemainingUwong() != 0) return false;
+            int uwongCount = popCount(state.getUwongBoard());
+            return uwongCount >= minUwong && uwongCount <= maxUwong;
+        }
+
+        uint8_t probe(const MacananGameState& state) const {
+            int uwongCount = popCount(state.getUwongBoard());
+            return tables[uwongCount][TablebaseIndex::encode(state.getMacanBoard(), state.getUwongBoard(),
+                                                            state.getSideToMove(), uwongCount)];
+        }
+    };
+
+    // Indeks posisi selama pembuatan disimpan sebagai uint32_t (UINT32_MAX sebagai penanda);
+    // tabel 8 Uwong (sekitar 8.9e9 posisi) tidak muat, 7 Uwong (sekitar 2.6e9) masih muat
+    const int TABLEBASE_MAX_UWONG = 7;
+
+    // Perkiraan memori kerja puncak: 3 byte per posisi selama analisis ditambah tabel hasil
+    // (1 byte per posisi) yang sudah jadi; daftar pending menambah sedikit di atas ini
+    inline uint64_t tablebaseWorkingMemory(int maxUwong) {
+        uint64_t finished = 0, peak = 0;
+        for (int k = RULES.minUwong; k <= maxUwong; k++) {
+            peak = max(peak, finished + TablebaseIndex::size(k) * 4);
+            finished += TablebaseIndex::size(k);
+        }
+        return peak;
+    }
+
+    // Pembuat tablebase dengan analisis mundur (retrograde), paralel per rentang indeks.
+    // Tabel untuk k Uwong bergantung pada tabel k - 1 karena lompatan Macan mengurangi Uwong.
+    class TablebaseGenerator {
+    private:
+        int threadCount;
+        vector<vector<uint8_t>> tables;  // tables[k]; kosong untuk k < RULES.minUwong
+
+        // Jalankan body(begin, end, thread) untuk potongan [0, count) di semua thread
+        template <class Body>
+        void parallelFor(uint64_t count, Body body) {
+            vector<thread> pool;
+            uint64_t chunk = (count + threadCount - 1) / threadCount;
+            for (int t = 0; t < threadCount; t++) {
+                uint64_t begin = min(count, chunk * t);
+                uint64_t end = min(count, begin + chunk);
+                pool.emplace_back(body, begin, end, t);
+            }
+            for (thread& worker : pool) worker.join();
+        }
+
+        // Nilai posisi setelah Macan melompat (Uwong jalan, k - 1 Uwong)
+        uint8_t valueAfterCapture(const MacananGameState& child) const {
+            if (child.isUwongDefeated()) return 0;
+            int uwongCount = popCount(child.getUwongBoard());
+            return tables[uwongCount][TablebaseIndex::encode(child.getMacanBoard(), child.getUwongBoard(),
+                                                            child.getSideToMove(), uwongCount)];
+        }
+
+        void solve(int uwongCount, ostream& log) {
+            auto start = chrono::steady_clock::now();
+            uint64_t size = TablebaseIndex::size(uwongCount);
+            vector<atomic<uint8_t>> values(size);
+            vector<atomic<uint8_t>> remainingChildren(size);
+            vector<uint8_t> externalMax(size);  // DTM terbesar anak hasil lompatan yang menang untuk lawan
+
+            // pending[d]: posisi yang nilainya baru pasti pada level d (ganjil menang, genap kalah)
+            vector<vector<uint32_t>> pending(TB_MAX_DISTANCE + 2);
+            vector<vector<vector<uint32_t>>> localPending(threadCount, vector<vector<uint32_t>>(TB_MAX_DISTANCE + 2));
+            vector<uint64_t> unused(threadCount);
+
+            // Tahap awal: posisi akhir, jumlah anak, dan anak di tabel k - 1
+            parallelFor(size, [&](uint64_t begin, uint64_t end, int t) {
+                MacananGameState state;
+                MoveList moves;
+                for (uint64_t index = begin; index < end; index++) {
+                    Bitboard macans, uwongs;
+                    Side side;
+                    TablebaseIndex::decode(index, uwongCount, macans, uwongs, side);
+                    values[index].store(TB_DRAW, memory_order_relaxed);
+                    externalMax[index] = 0;
+
+                    // Cermin yang bukan wakil kelasnya tidak pernah dibaca; jangan ikut propagasi
+                    if (TablebaseIndex::encode(macans, uwongs, side, uwongCount) != index) {
+                        remainingChildren[index].store(TB_DRAW, memory_order_relaxed);
+                        unused[t]++;
+                        continue;
+                    }
+                    state.setPieces(macans, uwongs, side, 0, 0);
+                    state.generateMoves(moves);
+
+                    // Anak dihitung per kelas posisi: dua langkah ke posisi yang saling cermin
+                    // hanya sekali, sesuai propagasi mundur yang juga sekali per pasangan kelas
+                    uint32_t childIndices[MAX_MOVES];
+                    int children = 0;
+                    int bestWin = TB_DRAW;
+                    int worstLoss = -1;
+                    for (const Move& move : moves) {
+                        state.makeMove(move);
+                        if (move.captured == NO_CELL) {
+                            childIndices[children++] = uint32_t(TablebaseIndex::encode(
+                                state.getMacanBoard(), state.getUwongBoard(), state.getSideToMove(), uwongCount));
+                            state.unmakeMove();
+                            continue;
+                        }
+                        uint8_t child = valueAfterCapture(state);
+                        state.unmakeMove();
+
+                        if (child == TB_DRAW) childIndices[children++] = UINT32_MAX;  // tidak pernah terselesaikan
+                        else if (child % 2 == 0) bestWin = min(bestWin, child + 1);
+                        else worstLoss = max(worstLoss, int(child));
+                    }
+                    sort(childIndices, childIndices + children);
+                    children = int(unique(childIndices, childIndices + children) - childIndices);
+
+                    // Posisi yang sudah pasti menang lewat lompatan tidak boleh ikut turun ke kalah
+                    remainingChildren[index].store(uint8_t(bestWin != TB_DRAW ? TB_DRAW : children),
+                                                   memory_order_relaxed);
+                    externalMax[index] = uint8_t(max(worstLoss, 0));
+
+                    if (bestWin != TB_DRAW) {
+                        localPending[t][min(bestWin, TB_MAX_DISTANCE + 1)].push_back(uint32_t(index));
+                    } else if (children == 0) {
+                        // Tidak ada langkah sama sekali (kalah sekarang), atau semua lompatan menang untuk lawan
+                        int distance = worstLoss < 0 ? 0 : worstLoss + 1;
+                        localPending[t][min(distance, TB_MAX_DISTANCE + 1)].push_back(uint32_t(index));
+                    }
+                }
+            });
+
+            auto mergePending = [&]() {
+                for (auto& local : localPending) {
+                    for (int d = 0; d <= TB_MAX_DISTANCE + 1; d++) {
+                        pending[d].insert(pending[d].end(), local[d].begin(), local[d].end());
+                        local[d].clear();
+                    }
+                }
+            };
+            mergePending();
+
+            // Propagasi mundur level demi level: posisi dengan DTM level menentukan pendahulunya
+            vector<uint32_t> frontier;
+            vector<vector<uint32_t>> localNext(threadCount);
+            int maxDistance = 0;
+            for (int level = 0; level <= TB_MAX_DISTANCE; level++) {
+                for (uint32_t index : pending[level]) {
+                    if (values[index].load(memory_order_relaxed) == TB_DRAW) {
+                        values[index].store(uint8_t(level), memory_order_relaxed);
+                        frontier.push_back(index);
+                    }
+                }
+                vector<uint32_t>().swap(pending[level]);
+                if (frontier.empty()) {
+                    bool more = false;
+                    for (int d = level + 1; d <= TB_MAX_DISTANCE; d++) more = more || !pending[d].empty();
+                    if (!more) break;
+                    continue;
+                }
+                maxDistance = level;
+
+                parallelFor(frontier.size(), [&](uint64_t begin, uint64_t end, int t) {
+                    MacananGameState state;
+                    MoveList retroMoves;
+                    for (uint64_t i = begin; i < end; i++) {
+                        Bitboard macans, uwongs;
+                        Side side;
+                        TablebaseIndex::decode(frontier[i], uwongCount, macans, uwongs, side);
+                        state.setPieces(macans, uwongs, side, 0, 0);
+                        state.generateRetroSteps(retroMoves);
+
+                        // Setiap kelas pendahulu diproses sekali saja
+                        Side mover = opponentOf(side);
+                        uint32_t parents[MAX_MOVES];
+                        int parentCount = 0;
+                        for (const Move& retro : retroMoves) {
+                            Bitboard change = (Bitboard(1) << retro.from) | (Bitboard(1) << retro.to);
+                            parents[parentCount++] = uint32_t(mover == SIDE_MACAN
+                                ? TablebaseIndex::encode(macans ^ change, uwongs, mover, uwongCount)
+                                : TablebaseIndex::encode(macans, uwongs ^ change, mover, uwongCount));
+                        }
+                        sort(parents, parents + parentCount);
+                        parentCount = int(unique(parents, parents + parentCount) - parents);
+
+                        for (int p = 0; p < parentCount; p++) {
+                            uint32_t parent = parents[p];
+                            if (values[parent].load(memory_order_relaxed) != TB_DRAW) continue;
+
+                            if (level % 2 == 0) {
+                                // Anak kalah untuk pemain jalannya: pendahulu menang
+                                uint8_t expected = TB_DRAW;
+                                if (values[parent].compare_exchange_strong(expected, uint8_t(level + 1))) {
+                                    localNext[t].push_back(uint32_t(parent));
+                                }
+                            } else if (remainingChildren[parent].fetch_sub(1) == 1) {
+                                // Semua anak menang untuk lawan: pendahulu kalah, selama mungkin
+                                int distance = 1 + max(level, int(externalMax[parent]));
+                                if (distance == level + 1) {
+                                    values[parent].store(uint8_t(distance), memory_order_relaxed);
+                                    localNext[t].push_back(uint32_t(parent));
+                                } else {
+                                    localPending[t][min(distance, TB_MAX_DISTANCE + 1)].push_back(uint32_t(parent));
+                                }
+                            }
+                        }
+                    }
+                });
+
+                frontier.clear();
+                for (auto& next : localNext) {
+                    frontier.insert(frontier.end(), next.begin(), next.end());
+                    next.clear();
+                }
+                mergePending();
+            }
+            if (!pending[TB_MAX_DISTANCE + 1].empty()) {
+                log << "Warning: " << pending[TB_MAX_DISTANCE + 1].size()
+                    << " positions exceed the maximum distance and are stored as draws" << endl;
+            }
+
+            vector<uint8_t>& table = tables[uwongCount];
+            table.resize(size);
+            uint64_t wins = 0, losses = 0, draws = 0;
+            for (uint64_t index = 0; index < size; index++) {
+                uint8_t value = values[index].load(memory_order_relaxed);
+                table[index] = value;
+                if (value == TB_DRAW) draws++;
+                else if (value % 2 == 1) wins++;
+                else losses++;
+            }
+            uint64_t mirrored = 0;
+            for (uint64_t count : unused) mirrored += count;
+            draws -= mirrored;
+
+            log << "Uwong " << uwongCount << ": " << size - mirrored << " positions, " << wins << " wins, "
+                << losses << " losses, " << draws << " draws (side to move), max DTM " << maxDistance
+                << ", " << fixed << setprecision(1) << elapsedMilliseconds(start) / 1000.0 << " s, "
+                << size * 4 / (1 << 20) << " MB working memory" << endl;
+        }
+
+    public:
+        explicit TablebaseGenerator(int threadCount)
+            : threadCount(max(1, threadCount)), tables(UWONG_COUNT + 1) {}
+
+        // Hitung tabel RULES.minUwong..maxUwong (paling banyak TABLEBASE_MAX_UWONG) lalu tulis ke path
+        bool generate(int maxUwong, const string& path, ostream& log) {
+            maxUwong = min(maxUwong, TABLEBASE_MAX_UWONG);
+            for (int k = RULES.minUwong; k <= maxUwong; k++) {
+                solve(k, log);
+            }
+
+            TablebaseHeader header = {};
+            memcpy(header.magic, "MCTB", 4);
+            header.version = TABLEBASE_VERSION;
+            header.minUwong = uint32_t(RULES.minUwong);
+            header.maxUwong = uint32_t(maxUwong);
+
+            uint64_t offset = sizeof(header);
+            for (int k = RULES.minUwong; k <= maxUwong; k++) {
+                header.offset[k] = offset;
+                offset += tables[k].size();
+            }
+
+            FILE* output = fopen(path.c_str(), "wb");
+            if (output == nullptr) return false;
+            bool ok = fwrite(&header, sizeof(header), 1, output) == 1;
+            for (int k = RULES.minUwong; k <= maxUwong && ok; k++) {
+                ok = fwrite(tables[k].data(), 1, tables[k].size(), output) == tables[k].size();
+            }
+            return fclose(output) == 0 && ok;
+        }
+    };
+
+    // Satu entri buku pembukaan; langkah disimpan dalam bingkai kanonik posisinya
+    struct BookEntry {
+        uint64_t key;      // kunci kanonik posisi
+        int8_t from;
+        int8_t to;
+        int8_t captured;
+        uint8_t depth;     // kedalaman pencarian saat buku dibuat
+        int32_t score;     // skor untuk pemain jalan
+    };
+
+    static_assert(sizeof(BookEntry) == 16, "Format berkas buku mengandalkan entri 16 byte");
+
+    struct BookHeader {
+        char magic[4];     // "MCBK"
+        uint32_t version;
+        uint64_t count;    // jumlah entri, terurut menurut key
+    };
+
+    const uint32_t BOOK_VERSION = 1;
+    const string DEFAULT_BOOK_FILE = "macanan.book";
+
+    // Buku pembukaan fase PLACING, dibaca lewat memory map; dicari dengan binary search
+    class OpeningBook {
+    private:
+        MappedFile file;
+        const BookEntry* entries;
+        uint64_t count;
+
+    public:
+        OpeningBook() : entries(nullptr), count(0) {}
+
+        bool load(const string& path) {
+            count = 0;
+            if (!file.open(path) || file.size() < sizeof(BookHeader)) return false;
+
+            BookHeader header;
+            memcpy(&header, file.data(), sizeof(header));
+            if (memcmp(header.magic, "MCBK", 4) != 0 || header.version != BOOK_VERSION ||
+                sizeof(header) + header.count * sizeof(BookEntry) > file.size()) {
+                file.close();
+                return false;
+            }
+            entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(header));
+            count = header.count;
+            return true;
+        }
+
+        bool isLoaded() const {
+            return count > 0;
+        }
+
+        uint64_t size() const {
+            return count;
+        }
+
+        // Langkah buku untuk state; false jika posisi tidak ada (atau langkahnya tidak sah)
+        bool probe(const MacananGameState& state, Move& move, int& score, int& depth) const {
+            if (count == 0) return false;
+            int symmetry = state.getCanonicalSymmetry();
+            uint64_t key = state.getHashKey(symmetry);
+            const BookEntry* entry = lower_bound(entries, entries + count, key,
+                [](const BookEntry& e, uint64_t k) { return e.key < k; });
+            if (entry == entries + count || entry->key != key) return false;
+
+            // Tabrakan hash: langkah harus ada di daftar langkah sah; keluaran tidak disentuh jika tidak
+            Move bookMove = mirrorMove({entry->from, entry->to, entry->captured}, symmetry);
+            MoveList moves;
+            state.generateMoves(moves);
+            if (find(moves.begin(), moves.end(), bookMove) == moves.end()) return false;
+
+            move = bookMove;
+            score = entry->score;
+            depth = entry->depth;
+            return true;
+        }
+    };
+
+    // Berkas bobot NNUE: NnueHeader lalu NnueWeights apa adanya (little-endian)
+    struct NnueHeader {
+        char magic[4];     // "MCNN"
+        uint32_t version;
+        uint32_t inputs;   // NNUE_INPUTS
+        uint32_t hidden;   // NNUE_HIDDEN
+    };
+
+    struct NnueWeights {
+        int16_t featureWeights[NNUE_INPUTS][NNUE_HIDDEN];   // skala NNUE_CLIP
+        int16_t featureBias[NNUE_HIDDEN];
+        int8_t outputWeights[2][NNUE_HIDDEN];               // per pemain jalan, skala NNUE_WEIGHT_SCALE
+        int32_t outputBias[2];                              // skala NNUE_CLIP * NNUE_WEIGHT_SCALE
+    };
+
+    const uint32_t NNUE_VERSION = 1;
+    const string DEFAULT_NNUE_FILE = "macanan.nnue";
+
+    typedef int32_t (*NnueOutputFunction)(const int16_t* accumulator, const int8_t* weights);
+
+    // Jumlah clamp(accumulator[i], 0, NNUE_CLIP) * weights[i]
+    int32_t nnueOutputScalar(const int16_t* accumulator, const int8_t* weights) {
+        int32_t sum = 0;
+        for (int i = 0; i < NNUE_HIDDEN; i++) {
+            sum += min(max<int>(accumulator[i], 0), NNUE_CLIP) * weights[i];
+        }
+        return sum;
+    }
+
+    #ifdef MACANAN_X86
+    __attribute__((target("avx2"))) int32_t nnueOutputAvx2(const int16_t* accumulator, const int8_t* weights) {
+        const __m256i clip = _mm256_set1_epi16(NNUE_CLIP);
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+            __m256i low = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i)), clip);
+            __m256i high = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i + 16)), clip);
+            // packus memotong nilai negatif ke 0 tetapi menyilangkan lane 128-bit; permute mengembalikan urutan
+            __m256i activated = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(activated, w), ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+    }
+    #endif
+
+    inline NnueOutputFunction selectNnueOutput() {
+    #ifdef MACANAN_X86
+        if (__builtin_cpu_supports("avx2")) return nnueOutputAvx2;
+    #endif
+        return nnueOutputScalar;
+    }
+
+    const NnueOutputFunction NNUE_OUTPUT = selectNnueOutput();
+
+    // Bobot NNUE yang dibaca lewat memory map, tanpa salinan
+    class NnueNetwork {
+    private:
+        MappedFile file;
+        const NnueWeights* weights;
+
+    public:
+        NnueNetwork() : weights(nullptr) {}
+
+        bool load(const string& path) {
+            weights = nullptr;
+            if (!file.open(path) || file.size() != sizeof(NnueHeader) + sizeof(NnueWeights)) return false;
+
+            NnueHeader header;
+            memcpy(&header, file.data(), sizeof(header));
+            if (memcmp(header.magic, "MCNN", 4) != 0 || header.version != NNUE_VERSION ||
+                header.inputs != uint32_t(NNUE_INPUTS) || header.hidden != uint32_t(NNUE_HIDDEN)) {
+                file.close();
+                return false;
+            }
+            weights = reinterpret_cast<const NnueWeights*>(file.data() + sizeof(header));
+            return true;
+        }
+
+        bool isLoaded() const {
+            return weights != nullptr;
+        }
+
+        const int16_t* featureColumn(int feature) const {
+            return weights->featureWeights[feature];
+        }
+
+        const int16_t* featureBias() const {
+            return weights->featureBias;
+        }
+
+        // Skor untuk side dari akumulator, dalam satuan evaluasi buatan tangan
+        int evaluate(const int16_t* accumulator, Side side) const {
+            int64_t output = int64_t(NNUE_OUTPUT(accumulator, weights->outputWeights[side])) + weights->outputBias[side];
+            int64_t score = output * NNUE_OUTPUT_SCALE / (NNUE_CLIP * NNUE_WEIGHT_SCALE);
+            return int(max<int64_t>(-NNUE_MAX_SCORE, min<int64_t>(NNUE_MAX_SCORE, score)));
+        }
+
+        // Tulis bobot terkuantisasi ke path
+        static bool save(const string& path, const NnueWeights& values) {
+            NnueHeader header = {};
+            memcpy(header.magic, "MCNN", 4);
+            header.version = NNUE_VERSION;
+            header.inputs = NNUE_INPUTS;
+            header.hidden = NNUE_HIDDEN;
+
+            FILE* output = fopen(path.c_str(), "wb");
+            if (output == nullptr) return false;
+            bool ok = fwrite(&header, sizeof(header), 1, output) == 1 &&
+                      fwrite(&values, sizeof(values), 1, output) == 1;
+            return fclose(output) == 0 && ok;
+        }
+    };
+
+    inline void MacananGameState::updateAccumulator(int feature, int sign) {
+        addNnueColumn(accumulator, network->featureColumn(feature), sign);
+    }
+
+    void MacananGameState::refreshAccumulator() {
+        memcpy(accumulator, network->featureBias(), sizeof(accumulator));
+        for (Bitboard macans = macanBoard; macans; ) {
+            addNnueColumn(accumulator, network->featureColumn(nnueFeature(SIDE_MACAN, popLowestCell(macans))), 1);
+        }
+        for (Bitboard uwongs = uwongBoard; uwongs; ) {
+            addNnueColumn(accumulator, network->featureColumn(nnueFeature(SIDE_UWONG, popLowestCell(uwongs))), 1);
+        }
+    }
+
+    int MacananGameState::evaluateNetwork() const {
+        return network->evaluate(accumulator, sideToMove);
+    }
+
+    const int MAX_PLY = 64;
+    const int INFINITE_SCORE = 1000000;
+    // Skor menang/kalah; dikurangi ply agar kemenangan tercepat lebih disukai
+    const int WIN_SCORE = 900000;
+    // Skor di atas batas ini adalah kemenangan pasti (dari pencarian atau tablebase)
+    const int WIN_THRESHOLD = WIN_SCORE - 1000;
+
+    // Skor negamax untuk nilai tablebase pada jarak ply dari akar
+    inline int tablebaseScore(uint8_t value, int ply) {
+        if (value == TB_DRAW) return 0;
+        int score = WIN_SCORE - (ply + value);
+        return value % 2 == 1 ? score : -score;
+    }
+
+    enum BoundType : uint8_t {
+        BOUND_NONE = 0,
+        BOUND_UPPER = 1,  // skor sebenarnya <= skor tersimpan (fail-low)
+        BOUND_LOWER = 2,  // skor sebenarnya >= skor tersimpan (fail-high)
+        BOUND_EXACT = 3
+    };
+
+    struct TTEntry {
+        Move move;
+        int score;
+        int depth;
+        BoundType bound;
+    };
+
+    // Skor menang disimpan relatif terhadap node, bukan terhadap akar
+    inline int scoreToTable(int score, int ply) {
+        if (score >= WIN_THRESHOLD) return score + ply;
+        if (score <= -WIN_THRESHOLD) return score - ply;
+        return score;
+    }
+
+    inline int scoreFromTable(int score, int ply) {
+        if (score >= WIN_THRESHOLD) return score - ply;
+        if (score <= -WIN_THRESHOLD) return score + ply;
+        return score;
+    }
+
+    // Batas delta pruning quiescence: perubahan evaluasi terbesar dari satu lompatan
+    // (satu Uwong hilang beserta bonus formasi dan kontaknya)
+    const int QUIESCENCE_DELTA = 400;
+
+    // Angka bukti/sanggahan df-pn (dari sisi pemain jalan): phi 0 berarti pemain jalan pasti menang,
+    // delta 0 berarti pasti kalah
+    const uint32_t PROOF_INFINITY = (1u << 25) - 1;
+
+    // Entri df-pn di tabel transposisi bersama
+    struct ProofEntry {
+        uint32_t phi;
+        uint32_t delta;
+        uint64_t work;   // perkiraan jumlah node di bawah posisi ini (pangkat dua)
+    };
+
+    // Entri df-pn disimpan dengan kunci key ^ PROOF_KEY_SALT, jadi tidak pernah dibaca sebagai entri alpha-beta
+    const uint64_t PROOF_KEY_SALT = 0x9E3779B97F4A7C15ULL;
+
+    // Tabel transposisi ukuran tetap dengan penggantian berdasarkan kedalaman.
+    // Dipakai bersama oleh semua thread tanpa lock: kunci disimpan sebagai key ^ data,
+    // sehingga slot yang setengah tertulis oleh thread lain terbaca sebagai miss.
+    class TranspositionTable {
+    private:
+        // 16 byte per slot: kunci Zobrist (di-XOR dengan data) + data yang dipadatkan
+        struct Slot {
+            atomic<uint64_t> key{0};
+            atomic<uint64_t> data{0};
+        };
+
+        vector<Slot> slots;
+        uint64_t indexMask;
+        uint8_t generation;
+
+        // data: skor (32 bit) | from, to, captured masing-masing +1 (6 bit) | depth (8 bit) | bound (2 bit) | generation (4 bit)
+        static uint64_t packCell(int8_t cell) {
+            return uint64_t(cell + 1) & 0x3F;
+        }
+
+        static int8_t unpackCell(uint64_t bits) {
+            return int8_t(int(bits & 0x3F) - 1);
+        }
+
+        static Move slotMove(uint64_t data) {
+            return {unpackCell(data >> 32), unpackCell(data >> 38), unpackCell(data >> 44)};
+        }
+
+        static int slotDepth(uint64_t data) { return int((data >> 50) & 0xFF); }
+        static BoundType slotBound(uint64_t data) { return BoundType((data >> 58) & 0x3); }
+        static uint8_t slotGeneration(uint64_t data) { return uint8_t((data >> 60) & 0xF); }
+
+    public:
+        explicit TranspositionTable(size_t megabytes) : indexMask(0), generation(0) {
+            resize(megabytes);
+        }
+
+        // Ukuran dibulatkan ke bawah ke pangkat dua agar indeks cukup dengan mask
+        void resize(size_t megabytes) {
+            size_t count = 1;
+            while (count * 2 * sizeof(Slot) <= (megabytes << 20)) count *= 2;
+            slots = vector<Slot>(count);
+            indexMask = count - 1;
+        }
+
+        void clear() {
+            for (Slot& slot : slots) {
+                slot.key.store(0, memory_order_relaxed);
+                slot.data.store(0, memory_order_relaxed);
+            }
+        }
+
+        size_t sizeInBytes() const {
+            return slots.size() * sizeof(Slot);
+        }
+
+        // Dipanggil setiap awal pencarian; entri generasi lama boleh langsung ditimpa
+        void newSearch() {
+            generation = (generation + 1) & 0xF;
+        }
+
+        bool probe(uint64_t key, TTEntry& entry) const {
+            const Slot& slot = slots[key & indexMask];
+            uint64_t data = slot.data.load(memory_order_relaxed);
+            if ((slot.key.load(memory_order_relaxed) ^ data) != key || slotBound(data) == BOUND_NONE) return false;
+
+            entry.score = int32_t(uint32_t(data));
+            entry.move = slotMove(data);
+            entry.depth = slotDepth(data);
+            entry.bound = slotBound(data);
+            return true;
+        }
+
+        void store(uint64_t key, Move move, int score, int depth, BoundType bound) {
+            Slot& slot = slots[key & indexMask];
+            uint64_t oldData = slot.data.load(memory_order_relaxed);
+            bool sameKey = (slot.key.load(memory_order_relaxed) ^ oldData) == key;
+
+            // Entri lebih dalam dari pencarian yang sama tidak ditimpa
+            if (!sameKey && slotGeneration(oldData) == generation && depth < slotDepth(oldData)) return;
+
+            // Pertahankan langkah lama jika posisi sama dan langkah baru tidak ada
+            if (sameKey && move == NO_MOVE) {
+                move = slotMove(oldData);
+            }
+
+            uint64_t data = uint64_t(uint32_t(score)) |
+                            packCell(move.from) << 32 | packCell(move.to) << 38 | packCell(move.captured) << 44 |
+                            uint64_t(max(0, min(depth, 255))) << 50 | uint64_t(bound) << 58 |
+                            uint64_t(generation) << 60;
+            slot.key.store(key ^ data, memory_order_relaxed);
+            slot.data.store(data, memory_order_relaxed);
+        }
+
+        // Entri df-pn: phi (25 bit) | delta (25 bit) | ukuran (8 bit) | BOUND_NONE | generation.
+        // Ukuran 1 + log2(work), ditambah 64 untuk posisi yang sudah terbukti, mengisi tempat depth
+        // sehingga entri alpha-beta menilainya dengan aturan penggantian yang sama. Entri df-pn
+        // menempati salah satu dari dua slot bertetangga (index dan index ^ 1).
+        static bool isProofData(uint64_t data) {
+            return data != 0 && slotBound(data) == BOUND_NONE;
+        }
+
+        static int proofSize(uint32_t phi, uint32_t delta, uint64_t work) {
+            int size = 1;
+            while (work >>= 1) size++;
+            return phi == 0 || delta == 0 ? size + 64 : size;
+        }
+
+        bool probeProof(uint64_t key, ProofEntry& entry) const {
+            key ^= PROOF_KEY_SALT;
+            for (size_t index : {key & indexMask, (key & indexMask) ^ 1}) {
+                const Slot& slot = slots[index];
+                uint64_t data = slot.data.load(memory_order_relaxed);
+                if ((slot.key.load(memory_order_relaxed) ^ data) != key || !isProofData(data)) continue;
+
+                entry.phi = uint32_t(data & PROOF_INFINITY);
+                entry.delta = uint32_t((data >> 25) & PROOF_INFINITY);
+                entry.work = uint64_t(1) << ((slotDepth(data) & 63) - 1);
+                return true;
+            }
+            return false;
+        }
+
+        // Selalu tersimpan, agar df-pn tetap maju; yang diganti adalah slot dengan kunci sama, lalu
+        // slot kosong atau generasi lama, lalu slot berukuran lebih kecil. false jika entri lain dari
+        // pencarian ini tergusur (tabel penuh, saatnya garbage collection).
+        bool storeProof(uint64_t key, uint32_t phi, uint32_t delta, uint64_t work) {
+            key ^= PROOF_KEY_SALT;
+            Slot* candidates[2] = {&slots[key & indexMask], &slots[(key & indexMask) ^ 1]};
+            Slot* target = nullptr;
+            for (Slot* slot : candidates) {
+                if ((slot->key.load(memory_order_relaxed) ^ slot->data.load(memory_order_relaxed)) == key) target = slot;
+            }
+            bool displaced = false;
+            if (target == nullptr) {
+                uint64_t first = candidates[0]->data.load(memory_order_relaxed);
+                uint64_t second = candidates[1]->data.load(memory_order_relaxed);
+                auto value = [&](uint64_t data) {
+                    return data == 0 || slotGeneration(data) != generation ? -1 : slotDepth(data);
+                };
+                target = value(second) < value(first) ? candidates[1] : candidates[0];
+                displaced = value(target->data.load(memory_order_relaxed)) >= 0;
+            }
+
+            int size = proofSize(phi, delta, work);
+            uint64_t data = uint64_t(min(phi, PROOF_INFINITY)) | uint64_t(min(delta, PROOF_INFINITY)) << 25 |
+                            uint64_t(size) << 50 | uint64_t(BOUND_NONE) << 58 | uint64_t(generation) << 60;
+            target->key.store(key ^ data, memory_order_relaxed);
+            target->data.store(data, memory_order_relaxed);
+            return !displaced;
+        }
+
+        size_t countProofEntries() const {
+            size_t count = 0;
+            for (const Slot& slot : slots) count += isProofData(slot.data.load(memory_order_relaxed));
+            return count;
+        }
+
+        // Garbage collection df-pn: buang entri yang belum terbukti dengan subpohon terkecil sampai
+        // setidaknya separuhnya hilang; entri alpha-beta dan posisi terbukti tidak disentuh.
+        // Mengembalikan jumlah entri yang dibuang.
+        size_t collectProofEntries() {
+            size_t sizes[64] = {}, unsolved = 0;
+            for (const Slot& slot : slots) {
+                uint64_t data = slot.data.load(memory_order_relaxed);
+                if (isProofData(data) && slotDepth(data) < 64) {
+                    sizes[slotDepth(data)]++;
+                    unsolved++;
+                }
+            }
+            int limit = 0;
+            for (size_t removed = 0; limit < 64 && removed < (unsolved + 1) / 2; limit++) removed += sizes[limit];
+
+            size_t removed = 0;
+            for (Slot& slot : slots) {
+                uint64_t data = slot.data.load(memory_order_relaxed);
+                if (isProofData(data) && slotDepth(data) < limit) {
+                    slot.key.store(0, memory_order_relaxed);
+                    slot.data.store(0, memory_order_relaxed);
+                    removed++;
+                }
+            }
+            return removed;
+        }
+    };
+
+    struct SearchResult {
+        Move bestMove;
+        int score;
+        int depth;
+        uint64_t nodes;
+        vector<Move> principalVariation;
+    };
+
+    // Batas satu pencarian; 0 berarti tidak dibatasi. Iterasi pertama selalu diselesaikan,
+    // setelah itu pencarian berhenti begitu batas tercapai dan memakai iterasi terakhir yang selesai.
+    struct SearchLimits {
+        int depth;          // kedalaman maksimum (alpha-beta)
+        double timeMs;      // waktu berpikir untuk langkah ini
+        uint64_t nodes;     // node (alpha-beta) atau playout (MCTS)
+    };
+
+    // Jam dan penghitung node dicek sekali setiap sekian node per thread
+    const uint64_t NODE_CHECK_INTERVAL = 1024;
+    // Iterasi baru tidak dimulai jika waktu yang terpakai sudah melewati bagian ini
+    const double SOFT_TIME_FRACTION = 0.5;
+
+    // Keadaan berhenti yang dibagi semua thread dalam satu pencarian
+    struct SearchControl {
+        atomic<bool> stop;
+        atomic<bool> armed;          // batas baru berlaku setelah iterasi pertama selesai
+        atomic<uint64_t> nodes;      // node semua thread, ditambah per NODE_CHECK_INTERVAL
+        SearchLimits limits;
+        chrono::steady_clock::time_point deadline;
+    };
+
+    // Penghitung instrumentasi pencarian; kompilasi dengan -DMACANAN_STATS=0 untuk membuangnya
+    #ifndef MACANAN_STATS
+    #define MACANAN_STATS 1
+    #endif
+
+    #if MACANAN_STATS
+    #define SEARCH_STAT(statement) statement
+    #else
+    #define SEARCH_STAT(statement) ((void)0)
+    #endif
+
+    // Cutoff menurut urutan langkah: langkah ke-0 .. ke-6, slot terakhir untuk ke-7 dan seterusnya
+    const int STATS_CUTOFF_SLOTS = 8;
+
+    // Penghitung per thread, tanpa atomik; dijumlahkan setelah pencarian selesai
+    struct SearchStats {
+        uint64_t quiescenceNodes;
+        uint64_t evaluations;
+        uint64_t generatedMoves;
+        uint64_t ttProbes;
+        uint64_t ttHits;
+        uint64_t ttCutoffs;          // hit tabel yang langsung mengembalikan skor
+        uint64_t tablebaseHits;
+        uint64_t cutoffsByIndex[STATS_CUTOFF_SLOTS];
+
+        void add(const SearchStats& other) {
+            quiescenceNodes += other.quiescenceNodes;
+            evaluations += other.evaluations;
+            generatedMoves += other.generatedMoves;
+            ttProbes += other.ttProbes;
+            ttHits += other.ttHits;
+            ttCutoffs += other.ttCutoffs;
+            tablebaseHits += other.tablebaseHits;
+            for (int i = 0; i < STATS_CUTOFF_SLOTS; i++) cutoffsByIndex[i] += other.cutoffsByIndex[i];
+        }
+    };
+
+    // Ringkasan satu keputusan langkah: penghitung semua thread dan waktu per tahap
+    struct MoveStats {
+        SearchStats search;
+        uint64_t nodes;
+        int threads;
+        int depth;
+        double effectiveBranching;   // node iterasi terakhir / node iterasi sebelumnya (thread utama)
+        double bookMs;               // cek buku pembukaan (alpha-beta) atau pemakaian ulang pohon (MCTS)
+        double searchMs;             // iterative deepening / playout
+        double stopMs;               // menghentikan dan menunggu thread pembantu
+        uint64_t treeNodes;          // ukuran pohon MCTS
+    };
+
+    // Engine AI yang bisa dipilih saat runtime: alpha-beta (SearchEngine) atau MCTS (MctsEngine)
+    class AIEngine {
+    public:
+        virtual ~AIEngine() {}
+
+        virtual SearchResult search(const MacananGameState& root, const SearchLimits& limits) = 0;
+
+        // Lupakan semua yang dipelajari dari permainan sebelumnya
+        virtual void newGame() = 0;
+
+        // Minta pencarian yang sedang berjalan (di thread lain) berhenti secepatnya
+        virtual void stop() = 0;
+
+        // Instrumentasi pencarian terakhir
+        virtual MoveStats getMoveStats() const = 0;
+    };
+
+    // Jenis langkah menurut urutan pencarian: langkah tabel/PV, makan, killer, sisanya (history)
+    enum MoveKind {
+        KIND_HASH,
+        KIND_CAPTURE,
+        KIND_KILLER,
+        KIND_QUIET,
+        MOVE_KIND_COUNT
+    };
+
+    // Prioritas urutan langkah; langkah biasa memakai nilai history (selalu < ORDER_KILLER)
+    const int ORDER_HASH = 1 << 30;
+    const int ORDER_PV = ORDER_HASH - 1;
+    const int ORDER_CAPTURE = 1 << 29;
+    const int ORDER_KILLER = 1 << 28;
+    const int HISTORY_LIMIT = 1 << 20;
+
+    // Statistik cutoff beta, untuk melihat seberapa baik urutan langkah
+    struct CutoffStats {
+        uint64_t cutoffs;
+        uint64_t firstMoveCutoffs;          // cutoff oleh langkah pertama yang dicoba
+        uint64_t byKind[MOVE_KIND_COUNT];
+
+        void add(const CutoffStats& other) {
+            cutoffs += other.cutoffs;
+            firstMoveCutoffs += other.firstMoveCutoffs;
+            for (int kind = 0; kind < MOVE_KIND_COUNT; kind++) byKind[kind] += other.byKind[kind];
+        }
+    };
+
+    // Negamax dengan alpha-beta pruning untuk fase PLACING dan MOVING; satu worker per thread
+    class SearchWorker {
+    private:
+        TranspositionTable& table;
+        SearchControl& control;
+        const EndgameTablebase* tablebase;
+        const NnueNetwork* network;
+        MacananGameState state;
+        uint64_t nodes;
+        Move pvTable[MAX_PLY][MAX_PLY];
+        int pvLength[MAX_PLY];
+        Move previousPv[MAX_PLY];
+        int previousPvLength;
+        Move killers[MAX_PLY][2];                          // langkah biasa yang baru saja menyebabkan cutoff
+        int history[2][BOARD_CELLS + 1][BOARD_CELLS];      // [pemain][from, BOARD_CELLS = penempatan][to]
+        CutoffStats stats;
+        SearchStats counters;
+
+        // Hitung satu node; setiap NODE_CHECK_INTERVAL node cek jam dan jumlah node semua thread
+        void countNode() {
+            if ((++nodes & (NODE_CHECK_INTERVAL - 1)) != 0) return;
+            uint64_t total = control.nodes.fetch_add(NODE_CHECK_INTERVAL, memory_order_relaxed) + NODE_CHECK_INTERVAL;
+            if (!control.armed.load(memory_order_relaxed)) return;
+            const SearchLimits& limits = control.limits;
+            if ((limits.nodes > 0 && total >= limits.nodes) ||
+                (limits.timeMs > 0 && chrono::steady_clock::now() >= control.deadline)) {
+                control.stop.store(true, memory_order_relaxed);
+            }
+        }
+
+        int& historyOf(Side side, const Move& move) {
+            return history[side][move.from == NO_CELL ? BOARD_CELLS : move.from][move.to];
+        }
+
+        // Skor urutan untuk setiap langkah: tabel, PV, makan, killer, lalu history
+        void scoreMoves(const MoveList& moves, const Move& hashMove, const Move& pvMove, int ply, int* scores) {
+            Side side = state.getSideToMove();
+            for (int i = 0; i < moves.size(); i++) {
+                const Move& move = moves[i];
+                if (move == hashMove) scores[i] = ORDER_HASH;
+                else if (move == pvMove) scores[i] = ORDER_PV;
+                else if (move.captured != NO_CELL) scores[i] = ORDER_CAPTURE;
+                else if (move == killers[ply][0]) scores[i] = ORDER_KILLER;
+                else if (move == killers[ply][1]) scores[i] = ORDER_KILLER - 1;
+                else scores[i] = historyOf(side, move);
+            }
+        }
+
+        // Pindahkan langkah dengan skor terbesar dari [index, size) ke index
+        static void pickNextMove(MoveList& moves, int* scores, int index) {
+            int best = index;
+            for (int i = index + 1; i < moves.size(); i++) {
+                if (scores[i] > scores[best]) best = i;
+            }
+            swap(moves[index], moves[best]);
+            swap(scores[index], scores[best]);
+        }
+
+        // Catat cutoff: statistik, lalu killer dan history untuk langkah yang bukan makan
+        void recordCutoff(const Move& move, int orderScore, int moveNumber, int depth, int ply) {
+            SEARCH_STAT(counters.cutoffsByIndex[min(moveNumber, STATS_CUTOFF_SLOTS - 1)]++);
+            stats.cutoffs++;
+            if (moveNumber == 0) stats.firstMoveCutoffs++;
+            stats.byKind[orderScore >= ORDER_PV ? KIND_HASH
+                       : orderScore >= ORDER_CAPTURE ? KIND_CAPTURE
+                       : orderScore >= ORDER_KILLER - 1 ? KIND_KILLER : KIND_QUIET]++;
+            if (move.captured != NO_CELL) return;
+
+            if (!(move == killers[ply][0])) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = move;
+            }
+            int& entry = historyOf(state.getSideToMove(), move);
+            entry += depth * depth;
+            if (entry > HISTORY_LIMIT) ageHistory();
+        }
+
+        void ageHistory() {
+            for (auto& side : history) {
+                for (auto& from : side) {
+                    for (int& value : from) value /= 2;
+                }
+            }
+        }
+
+        // Quiescence search: lompatan Macan dan balasan Uwong yang menutupnya diteruskan
+        // sampai posisi tenang, baru evaluasi statis dipakai (stand-pat + delta pruning)
+        int quiescence(int alpha, int beta, int ply) {
+            if (control.stop.load(memory_order_relaxed)) return 0;
+
+            countNode();
+            SEARCH_STAT(counters.quiescenceNodes++);
+            pvLength[ply] = ply;
+
+            if (state.isUwongDefeated()) {
+                return state.getSideToMove() == SIDE_MACAN ? WIN_SCORE - ply : -(WIN_SCORE - ply);
+            }
+            if (tablebase != nullptr && tablebase->covers(state)) {
+                SEARCH_STAT(counters.tablebaseHits++);
+                return tablebaseScore(tablebase->probe(state), ply);
+            }
+            MoveList moves;
+            state.generateMoves(moves);
+            SEARCH_STAT(counters.generatedMoves += moves.size());
+            if (moves.empty()) {
+                return -(WIN_SCORE - ply);
+            }
+
+            // Stand-pat: pemain jalan boleh tidak melanjutkan pertukaran
+            int bestScore = state.evaluateForSideToMove();
+            SEARCH_STAT(counters.evaluations++);
+            if (bestScore >= beta || ply >= MAX_PLY - 1) return bestScore;
+            alpha = max(alpha, bestScore);
+
+            MoveList tactical;
+            state.generateTacticalMoves(tactical);
+            SEARCH_STAT(counters.generatedMoves += tactical.size());
+            bool macanToMove = state.getSideToMove() == SIDE_MACAN;
+            for (const Move& move : tactical) {
+                // Delta pruning: satu lompatan tidak bisa menaikkan skor sebanyak ini,
+                // kecuali lompatan yang langsung memenangkan permainan
+                if (macanToMove && bestScore + QUIESCENCE_DELTA <= alpha && !state.isLastCapture()) break;
+
+                state.makeMove(move);
+                int score = -quiescence(-beta, -alpha, ply + 1);
+                state.unmakeMove();
+                if (control.stop.load(memory_order_relaxed)) return 0;
+
+                if (score > bestScore) {
+                    bestScore = score;
+                    if (score > alpha) {
+                        alpha = score;
+                        pvTable[ply][ply] = move;
+                        for (int i = ply + 1; i < pvLength[ply + 1]; i++) {
+                            pvTable[ply][i] = pvTable[ply + 1][i];
+                        }
+                        pvLength[ply] = pvLength[ply + 1];
+                    }
+                }
+                if (alpha >= beta) break;
+            }
+            return bestScore;
+        }
+
+        int negamax(int depth, int alpha, int beta, int ply) {
+            // Thread lain sudah selesai; hasil cabang ini tidak dipakai
+            if (control.stop.load(memory_order_relaxed)) return 0;
+
+            // Di horizon: selesaikan dulu pertukaran makan yang sedang berjalan
+            if (depth <= 0 && ply > 0) return quiescence(alpha, beta, ply);
+
+            countNode();
+            pvLength[ply] = ply;
+
+            // Posisi akhir: Uwong sudah terlalu sedikit, atau pemain jalan tidak punya langkah
+            if (state.isUwongDefeated()) {
+                return state.getSideToMove() == SIDE_MACAN ? WIN_SCORE - ply : -(WIN_SCORE - ply);
+            }
+            // Akhir permainan yang sudah dihitung: nilai pasti tanpa pencarian
+            if (ply > 0 && tablebase != nullptr && tablebase->covers(state)) {
+                SEARCH_STAT(counters.tablebaseHits++);
+                return tablebaseScore(tablebase->probe(state), ply);
+            }
+            MoveList moves;
+            state.generateMoves(moves);
+            SEARCH_STAT(counters.generatedMoves += moves.size());
+            if (moves.empty()) {
+                return -(WIN_SCORE - ply);
+            }
+
+            if (ply >= MAX_PLY - 1) {
+                SEARCH_STAT(counters.evaluations++);
+                return state.evaluateForSideToMove();
+            }
+
+            // Posisi yang sudah pernah dicari cukup dalam bisa langsung dipakai (kecuali di akar).
+            // Tabel memakai kunci kanonik, jadi posisi cermin berbagi satu entri.
+            TTEntry entry;
+            Move hashMove = NO_MOVE;
+            int symmetry = state.getCanonicalSymmetry();
+            uint64_t key = state.getHashKey(symmetry);
+            SEARCH_STAT(counters.ttProbes++);
+            if (table.probe(key, entry)) {
+                SEARCH_STAT(counters.ttHits++);
+                hashMove = mirrorMove(entry.move, symmetry);
+                int ttScore = scoreFromTable(entry.score, ply);
+                if (ply > 0 && entry.depth >= depth &&
+                    (entry.bound == BOUND_EXACT ||
+                     (entry.bound == BOUND_LOWER && ttScore >= beta) ||
+                     (entry.bound == BOUND_UPPER && ttScore <= alpha))) {
+                    SEARCH_STAT(counters.ttCutoffs++);
+                    return ttScore;
+                }
+            }
+
+            // Urutan: langkah tabel, PV iterasi sebelumnya, makan, killer, history
+            int orderScores[MAX_MOVES];
+            scoreMoves(moves, hashMove, ply < previousPvLength ? previousPv[ply] : NO_MOVE, ply, orderScores);
+
+            int originalAlpha = alpha;
+            int bestScore = -INFINITE_SCORE;
+            Move bestMove = NO_MOVE;
+            for (int i = 0; i < moves.size(); i++) {
+                pickNextMove(moves, orderScores, i);
+                const Move& move = moves[i];
+                state.makeMove(move);
+                int score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+                state.unmakeMove();
+                if (control.stop.load(memory_order_relaxed)) return 0;
+
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestMove = move;
+                    if (score > alpha) {
+                        alpha = score;
+                        // Simpan PV: langkah ini diikuti PV dari anaknya
+                        pvTable[ply][ply] = move;
+                        for (int i = ply + 1; i < pvLength[ply + 1]; i++) {
+                            pvTable[ply][i] = pvTable[ply + 1][i];
+                        }
+                        pvLength[ply] = pvLength[ply + 1];
+                    }
+                }
+                if (alpha >= beta) {
+                    recordCutoff(move, orderScores[i], i, depth, ply);
+                    break;
+                }
+            }
+
+            BoundType bound = bestScore >= beta ? BOUND_LOWER
+                            : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+            table.store(key, mirrorMove(bestMove, symmetry), scoreToTable(bestScore, ply), depth, bound);
+            return bestScore;
+        }
+
+    public:
+        SearchWorker(TranspositionTable& table, SearchControl& control, const EndgameTablebase* tablebase,
+                     const NnueNetwork* network)
+            : table(table), control(control), tablebase(tablebase), network(network), nodes(0), pvLength(),
+              previousPvLength(0), history(), stats() {}
+
+        void setRoot(const MacananGameState& root) {
+            state = root;
+            state.clearUndoStack();
+            state.setNetwork(network);
+            nodes = 0;
+            previousPvLength = 0;
+            stats = CutoffStats();
+            counters = SearchStats();
+            fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, NO_MOVE);
+            ageHistory();
+        }
+
+        // Lupakan history dari permainan sebelumnya
+        void clearHistory() {
+            for (auto& side : history) {
+                for (auto& from : side) fill(begin(from), end(from), 0);
+            }
+        }
+
+        const CutoffStats& getCutoffStats() const {
+            return stats;
+        }
+
+        const SearchStats& getSearchStats() const {
+            return counters;
+        }
+
+        // Satu iterasi penuh pada depth; false jika dihentikan sebelum selesai
+        bool searchDepth(int depth, SearchResult& result) {
+            int score = negamax(depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+            if (control.stop.load(memory_order_relaxed) || pvLength[0] == 0) return false;
+
+            result.bestMove = pvTable[0][0];
+            result.score = score;
+            result.depth = depth;
+            result.principalVariation.assign(pvTable[0], pvTable[0] + pvLength[0]);
+
+            previousPvLength = pvLength[0];
+            copy(pvTable[0], pvTable[0] + pvLength[0], previousPv);
+            return true;
+        }
+
+        uint64_t getNodes() const {
+            return nodes;
+        }
+    };
+
+    // Iterative deepening; dengan lebih dari satu thread memakai Lazy SMP:
+    // thread pembantu mencari akar yang sama pada kedalaman berselang dan hanya
+    // berbagi tabel transposisi, sedangkan langkah akhir dipilih thread utama.
+    class SearchEngine : public AIEngine {
+    private:
+        int maxDepth;
+        int threadCount;
+        uint64_t nodes;
+        TranspositionTable table;
+        SearchControl control;
+        int depthLimit;
+        const EndgameTablebase* tablebase;
+        const OpeningBook* book;
+        const NnueNetwork* network;
+        vector<unique_ptr<SearchWorker>> workers;
+        MoveStats lastStats;
+
+        // Thread pembantu ke-id: kedalaman ganjil/genap bergantian agar tidak seragam dengan thread utama
+        void runHelper(int id) {
+            SearchResult ignored = {NO_MOVE, 0, 0, 0, {}};
+            SearchWorker& worker = *workers[id];
+            for (int depth = 1 + (id & 1); depth <= depthLimit; depth++) {
+                if (!worker.searchDepth(depth + (id >> 1 & 1), ignored)) break;
+            }
+        }
+
+    public:
+        SearchEngine(int maxDepth, size_t hashMegabytes = DEFAULT_HASH_MB)
+            : maxDepth(maxDepth), threadCount(0), nodes(0), table(hashMegabytes), depthLimit(maxDepth),
+              tablebase(nullptr), book(nullptr), network(nullptr), lastStats() {
+            setThreadCount(1);
+        }
+
+        void setMaxDepth(int depth) {
+            maxDepth = depth;
+        }
+
+        // Ukuran tabel transposisi dalam megabyte (isi tabel dikosongkan)
+        void setHashSize(size_t megabytes) {
+            table.resize(megabytes);
+        }
+
+        void clearHash() {
+            table.clear();
+        }
+
+        void newGame() override {
+            clearHash();
+            for (auto& worker : workers) worker->clearHistory();
+        }
+
+        void stop() override {
+            control.stop.store(true);
+        }
+
+        MoveStats getMoveStats() const override {
+            return lastStats;
+        }
+
+        // Statistik cutoff semua thread pada pencarian terakhir
+        CutoffStats getCutoffStats() const {
+            CutoffStats total = CutoffStats();
+            for (auto& worker : workers) total.add(worker->getCutoffStats());
+            return total;
+        }
+
+        void setThreadCount(int count) {
+            threadCount = max(1, count);
+            workers.clear();
+            for (int i = 0; i < threadCount; i++) {
+                workers.emplace_back(new SearchWorker(table, control, tablebase, network));
+            }
+        }
+
+        int getThreadCount() const {
+            return threadCount;
+        }
+
+        // Tablebase yang dipakai semua worker; nullptr untuk mematikan
+        void setTablebase(const EndgameTablebase* endgameTablebase) {
+            tablebase = endgameTablebase;
+            setThreadCount(threadCount);
+        }
+
+        // Buku pembukaan yang dicek sebelum mencari; nullptr untuk mematikan
+        void setBook(const OpeningBook* openingBook) {
+            book = openingBook;
+        }
+
+        // Evaluator NNUE untuk semua worker; nullptr memakai evaluasi buatan tangan
+        void setNetwork(const NnueNetwork* nnue) {
+            network = nnue;
+            clearHash();
+            setThreadCount(threadCount);
+        }
+
+        // Pencarian sampai kedalaman maksimum engine, tanpa batas waktu atau node
+        SearchResult search(const MacananGameState& root) {
+            return search(root, SearchLimits{maxDepth, 0, 0});
+        }
+
+        SearchResult search(const MacananGameState& root, const SearchLimits& limits) override {
+            SearchResult result = {NO_MOVE, 0, 0, 0, {}};
+            lastStats = MoveStats();
+            lastStats.threads = threadCount;
+            auto bookStart = chrono::steady_clock::now();
+            bool inBook = book != nullptr && book->probe(root, result.bestMove, result.score, result.depth);
+            lastStats.bookMs = elapsedMilliseconds(bookStart);
+            if (inBook) {
+                result.principalVariation.push_back(result.bestMove);
+                lastStats.depth = result.depth;
+                return result;
+            }
+            auto start = chrono::steady_clock::now();
+            table.newSearch();
+            control.limits = limits;
+            control.deadline = start + chrono::microseconds(int64_t(limits.timeMs * 1000));
+            control.nodes.store(0);
+            control.armed.store(false);
+            control.stop.store(false);
+            for (auto& worker : workers) worker->setRoot(root);
+
+            // Semua anak akar ada di tablebase, satu ply sudah pasti
+            depthLimit = limits.depth > 0 ? min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+            if (tablebase != nullptr && tablebase->covers(root)) depthLimit = 1;
+
+            vector<thread> helpers;
+            for (int id = 1; id < threadCount; id++) {
+                helpers.emplace_back(&SearchEngine::runHelper, this, id);
+            }
+
+            // Node thread utama per iterasi, untuk effective branching factor
+            uint64_t previousIteration = 0, lastIteration = 0, iterationStart = 0;
+            for (int depth = 1; depth <= depthLimit; depth++) {
+                if (!workers[0]->searchDepth(depth, result)) break;
+                control.armed.store(true);
+                previousIteration = lastIteration;
+                lastIteration = workers[0]->getNodes() - iterationStart;
+                iterationStart = workers[0]->getNodes();
+
+                // Kemenangan/kekalahan pasti sudah ditemukan, tidak perlu lebih dalam
+                if (abs(result.score) >= WIN_THRESHOLD) break;
+
+                // Iterasi berikutnya hampir pasti tidak selesai sebelum tenggat
+                if (limits.timeMs > 0 && elapsedMilliseconds(start) >= limits.timeMs * SOFT_TIME_FRACTION) break;
+                if (limits.nodes > 0 && control.nodes.load() >= limits.nodes) break;
+            }
+
+            lastStats.searchMs = elapsedMilliseconds(start);
+            auto stopStart = chrono::steady_clock::now();
+            control.stop.store(true);
+            for (thread& helper : helpers) helper.join();
+            lastStats.stopMs = elapsedMilliseconds(stopStart);
+
+            nodes = 0;
+            for (auto& worker : workers) {
+                nodes += worker->getNodes();
+                lastStats.search.add(worker->getSearchStats());
+            }
+            result.nodes = nodes;
+            lastStats.nodes = nodes;
+            lastStats.depth = result.depth;
+            lastStats.effectiveBranching = previousIteration > 0 ? double(lastIteration) / previousIteration : 0;
+            return result;
+        }
+    };
+
+    // Node pohon MCTS. Anak-anak satu node dialokasikan bersebelahan di arena.
+    struct MctsNode {
+        Move move;                        // langkah dari induk ke node ini
+        uint8_t childCount;
+        atomic<uint8_t> expansion;        // MCTS_UNEXPANDED, MCTS_EXPANDING, MCTS_EXPANDED, atau MCTS_LEAF
+        uint32_t firstChild;
+        atomic<uint32_t> visits;          // termasuk virtual loss dari thread yang sedang turun
+        atomic<uint32_t> reward;          // 2 per menang, 1 per seri, bagi pemain yang menjalankan move
+    };
+
+    const uint8_t MCTS_UNEXPANDED = 0;
+    const uint8_t MCTS_EXPANDING = 1;
+    const uint8_t MCTS_EXPANDED = 2;
+    const uint8_t MCTS_LEAF = 3;      // arena penuh saat ekspansi: daun permanen (bukan posisi akhir)
+    const uint32_t MCTS_NO_NODE = UINT32_MAX;
+
+    const double UCT_EXPLORATION = 1.4;
+    // Node diekspansi pada kunjungan kedua; kunjungan pertama hanya playout
+    const uint32_t MCTS_EXPAND_VISITS = 2;
+    // Playout yang belum selesai setelah sekian ply dihitung seri
+    const int MCTS_PLAYOUT_PLIES = 150;
+    const int DEFAULT_MCTS_PLAYOUTS = 20000;
+    const int DEFAULT_MCTS_MB = 64;
+
+    // Kumpulan node berukuran tetap; alokasi hanya menaikkan penghitung atomik
+    class MctsArena {
+    private:
+        unique_ptr<MctsNode[]> nodes;
+        uint32_t capacity;
+        atomic<uint32_t> used;
+
+    public:
+        explicit MctsArena(uint32_t capacity) : nodes(new MctsNode[capacity]), capacity(capacity), used(0) {}
+
+        // count node bersebelahan yang sudah dikosongkan, atau MCTS_NO_NODE jika arena penuh.
+        // used hanya maju jika blok muat, jadi tidak pernah melewati capacity (dan tidak wrap)
+        uint32_t allocate(int count, const Move* moves) {
+            uint32_t first = used.load(memory_order_relaxed);
+            do {
+                if (first + uint64_t(count) > capacity) return MCTS_NO_NODE;
+            } while (!used.compare_exchange_weak(first, first + uint32_t(count), memory_order_relaxed));
+            for (int i = 0; i < count; i++) {
+                MctsNode& node = nodes[first + i];
+                node.move = moves[i];
+                node.childCount = 0;
+                node.firstChild = MCTS_NO_NODE;
+                node.expansion.store(MCTS_UNEXPANDED, memory_order_relaxed);
+                node.visits.store(0, memory_order_relaxed);
+                node.reward.store(0, memory_order_relaxed);
+            }
+            return first;
+        }
+
+        void reset() {
+            used.store(0, memory_order_relaxed);
+        }
+
+        uint32_t size() const {
+            return used.load(memory_order_relaxed);
+        }
+
+        MctsNode& operator[](uint32_t index) {
+            return nodes[index];
+        }
+    };
+
+    // Monte Carlo Tree Search (UCT) multi-thread dengan virtual loss. Semua thread berbagi
+    // satu pohon di arena; subpohon langkah yang dimainkan dipindah ke arena kedua dan
+    // dipakai lagi pada pencarian berikutnya.
+    class MctsEngine : public AIEngine {
+    private:
+        int threadCount;
+        SearchLimits limits;
+        unique_ptr<MctsArena> arena;
+        unique_ptr<MctsArena> spare;
+        uint32_t root;
+        MacananGameState rootState;
+        atomic<uint64_t> playouts;
+        atomic<bool> stopFlag;
+        uint32_t searchCount;
+        MoveStats lastStats;
+
+        // Anak dengan nilai UCT terbesar; anak yang belum dikunjungi lebih dulu
+        uint32_t selectChild(MctsNode& node) {
+            uint32_t parentVisits = node.visits.load(memory_order_relaxed);
+            double logParent = log(double(max(parentVisits, 1u)));
+            uint32_t best = node.firstChild;
+            double bestValue = -1;
+            for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+                MctsNode& child = (*arena)[i];
+                uint32_t visits = child.visits.load(memory_order_relaxed);
+                if (visits == 0) return i;
+                double value = child.reward.load(memory_order_relaxed) / (2.0 * visits) +
+                               UCT_EXPLORATION * sqrt(logParent / visits);
+                if (value > bestValue) {
+                    bestValue = value;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // Pasang anak-anak node (satu per langkah sah); hanya satu thread yang berhasil
+        void expand(MctsNode& node, const MacananGameState& state) {
+            uint8_t expected = MCTS_UNEXPANDED;
+            if (!node.expansion.compare_exchange_strong(expected, MCTS_EXPANDING, memory_order_acquire)) return;
+
+            MoveList moves;
+            if (!state.isUwongDefeated()) state.generateMoves(moves);
+            uint32_t first = moves.empty() ? 0 : arena->allocate(moves.size(), moves.begin());
+            if (first == MCTS_NO_NODE) {
+                // Arena penuh: node menjadi daun permanen, tidak dicoba lagi; pencarian berlanjut
+                // dengan playout saja. keepSubtree memberinya kesempatan lagi di arena baru.
+                node.expansion.store(MCTS_LEAF, memory_order_release);
+                return;
+            }
+            node.firstChild = first;
+            node.childCount = uint8_t(moves.size());
+            node.expansion.store(MCTS_EXPANDED, memory_order_release);
+        }
+
+        // Main acak sampai selesai; Macan selalu makan jika bisa. Hasil: 2 Macan menang, 0 Uwong, 1 seri
+        static int playout(MacananGameState& state, mt19937& rng) {
+            for (int ply = 0; ply < MCTS_PLAYOUT_PLIES; ply++) {
+                if (state.isUwongDefeated()) return 2;
+                MoveList moves;
+                state.generateMoves(moves);
+                if (moves.empty()) return state.getSideToMove() == SIDE_MACAN ? 0 : 2;
+
+                const Move& move = moves[0].captured != NO_CELL ? moves[0] : moves[rng() % moves.size()];
+                state.makeMove(move);
+                state.clearUndoStack();
+            }
+            return 1;
+        }
+
+        // Satu iterasi: seleksi (dengan virtual loss), ekspansi, playout, propagasi balik
+        void iterate(mt19937& rng) {
+            MacananGameState state = rootState;
+            uint32_t path[MCTS_PLAYOUT_PLIES + MAX_PLY];
+            Side movers[MCTS_PLAYOUT_PLIES + MAX_PLY];
+            int length = 0;
+
+            uint32_t current = root;
+            (*arena)[current].visits.fetch_add(1, memory_order_relaxed);
+            path[length] = current;
+            movers[length++] = opponentOf(state.getSideToMove());
+
+            while (length < MAX_PLY) {
+                MctsNode& node = (*arena)[current];
+                uint8_t expansion = node.expansion.load(memory_order_acquire);
+                if (expansion != MCTS_EXPANDED) {
+                    if (expansion == MCTS_LEAF || node.visits.load(memory_order_relaxed) < MCTS_EXPAND_VISITS) break;
+                    expand(node, state);
+                    if (node.expansion.load(memory_order_acquire) != MCTS_EXPANDED) break;
+                }
+                if (node.childCount == 0) break;
+
+                // Virtual loss: kunjungan dicatat sekarang, hadiahnya baru saat propagasi balik
+                current = selectChild(node);
+                (*arena)[current].visits.fetch_add(1, memory_order_relaxed);
+                movers[length] = state.getSideToMove();
+                path[length++] = current;
+                state.makeMove((*arena)[current].move);
+                state.clearUndoStack();
+            }
+
+            int macanReward = playout(state, rng);
+            for (int i = 0; i < length; i++) {
+                uint32_t reward = movers[i] == SIDE_MACAN ? macanReward : 2 - macanReward;
+                (*arena)[path[i]].reward.fetch_add(reward, memory_order_relaxed);
+            }
+        }
+
+        void runThread(int id, chrono::steady_clock::time_point start) {
+            mt19937 rng(searchCount * 7919 + id);
+            for (uint32_t count = 0; !stopFlag.load(memory_order_relaxed); count++) {
+                if (playouts.fetch_add(1, memory_order_relaxed) >= limits.nodes) break;
+                iterate(rng);
+                if (limits.timeMs > 0 && count % 64 == 0 && elapsedMilliseconds(start) >= limits.timeMs) {
+                    stopFlag.store(true, memory_order_relaxed);
+                }
+            }
+        }
+
+        // Salin subpohon from ke arena cadangan (penomoran baru, bersebelahan), lalu tukar arena
+        uint32_t keepSubtree(uint32_t from) {
+            spare->reset();
+            uint32_t newRoot = spare->allocate(1, &(*arena)[from].move);
+            vector<pair<uint32_t, uint32_t>> queue = {{from, newRoot}};
+            for (size_t i = 0; i < queue.size(); i++) {
+                MctsNode& source = (*arena)[queue[i].first];
+                MctsNode& target = (*spare)[queue[i].second];
+                target.visits.store(source.visits.load(memory_order_relaxed), memory_order_relaxed);
+                target.reward.store(source.reward.load(memory_order_relaxed), memory_order_relaxed);
+                if (source.expansion.load(memory_order_relaxed) != MCTS_EXPANDED) continue;
+
+                Move moves[MAX_MOVES];
+                for (int c = 0; c < source.childCount; c++) moves[c] = (*arena)[source.firstChild + c].move;
+                uint32_t first = source.childCount == 0 ? 0 : spare->allocate(source.childCount, moves);
+                if (first == MCTS_NO_NODE) continue;
+                target.firstChild = first;
+                target.childCount = source.childCount;
+                target.expansion.store(MCTS_EXPANDED, memory_order_relaxed);
+                for (int c = 0; c < source.childCount; c++) {
+                    queue.push_back({source.firstChild + c, first + c});
+                }
+            }
+            swap(arena, spare);
+            return newRoot;
+        }
+
+        // Cari node untuk posisi baru di antara anak dan cucu akar lama (langkah sendiri + balasan)
+        uint32_t findReusableNode(const MacananGameState& state) {
+            if (root == MCTS_NO_NODE) return MCTS_NO_NODE;
+            if (rootState.getHashKey() == state.getHashKey()) return root;  // misalnya setelah pondering
+            vector<pair<uint32_t, MacananGameState>> candidates = {{root, rootState}};
+            for (int ply = 0; ply < 2; ply++) {
+                vector<pair<uint32_t, MacananGameState>> next;
+                for (auto& candidate : candidates) {
+                    MctsNode& node = (*arena)[candidate.first];
+                    if (node.expansion.load(memory_order_relaxed) != MCTS_EXPANDED) continue;
+                    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+                        MacananGameState child = candidate.second;
+                        child.makeMove((*arena)[i].move);
+                        child.clearUndoStack();
+                        if (child.getHashKey() == state.getHashKey()) return i;
+                        if (ply == 0) next.push_back({i, child});
+                    }
+                }
+                candidates.swap(next);
+            }
+            return MCTS_NO_NODE;
+        }
+
+    public:
+        explicit MctsEngine(int threadCount, int megabytes = DEFAULT_MCTS_MB)
+            : threadCount(max(1, threadCount)), limits(), root(MCTS_NO_NODE), playouts(0), stopFlag(false), searchCount(0),
+              lastStats() {
+            // Dua arena: pohon aktif dan tujuan penyalinan subpohon yang dipakai lagi
+            uint32_t capacity = uint32_t(size_t(max(1, megabytes)) * 1024 * 1024 / 2 / sizeof(MctsNode));
+            arena.reset(new MctsArena(capacity));
+            spare.reset(new MctsArena(capacity));
+        }
+
+        void newGame() override {
+            root = MCTS_NO_NODE;
+            arena->reset();
+        }
+
+        void stop() override {
+            stopFlag.store(true);
+        }
+
+        MoveStats getMoveStats() const override {
+            return lastStats;
+        }
+
+        // Batas node berarti jumlah playout; tanpa batas sama sekali dipakai DEFAULT_MCTS_PLAYOUTS
+        SearchResult search(const MacananGameState& state, const SearchLimits& searchLimits) override {
+            SearchResult result = {NO_MOVE, 0, 0, 0, {}};
+            limits = searchLimits;
+            if (limits.nodes == 0) limits.nodes = limits.timeMs > 0 ? UINT64_MAX : DEFAULT_MCTS_PLAYOUTS;
+            lastStats = MoveStats();
+            lastStats.threads = threadCount;
+            auto reuseStart = chrono::steady_clock::now();
+            uint32_t reused = findReusableNode(state);
+            if (reused != MCTS_NO_NODE) {
+                root = keepSubtree(reused);
+            } else {
+                arena->reset();
+                root = arena->allocate(1, &NO_MOVE);
+            }
+            rootState = state;
+            rootState.clearUndoStack();
+            lastStats.bookMs = elapsedMilliseconds(reuseStart);
+
+            playouts.store(0);
+            stopFlag.store(false);
+            searchCount++;
+            auto start = chrono::steady_clock::now();
+            vector<thread> helpers;
+            for (int id = 1; id < threadCount; id++) {
+                helpers.emplace_back(&MctsEngine::runThread, this, id, start);
+            }
+            runThread(0, start);
+            lastStats.searchMs = elapsedMilliseconds(start);
+            auto stopStart = chrono::steady_clock::now();
+            for (thread& helper : helpers) helper.join();
+            lastStats.stopMs = elapsedMilliseconds(stopStart);
+            result.nodes = min(playouts.load(), limits.nodes);
+            lastStats.nodes = result.nodes;
+            lastStats.treeNodes = arena->size();
+
+            // Langkah terpilih: anak yang paling sering dikunjungi; PV mengikuti aturan yang sama
+            for (uint32_t current = root; result.principalVariation.size() < MAX_PLY; ) {
+                MctsNode& node = (*arena)[current];
+                if (node.expansion.load() != MCTS_EXPANDED || node.childCount == 0) break;
+                uint32_t best = node.firstChild;
+                for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+                    if ((*arena)[i].visits.load() > (*arena)[best].visits.load()) best = i;
+                }
+                if ((*arena)[best].visits.load() == 0) break;
+                if (current == root) {
+                    // Skor: peluang menang pemain jalan, -1000..1000
+                    MctsNode& chosen = (*arena)[best];
+                    result.score = int(lround((chosen.reward.load() / double(chosen.visits.load()) - 1.0) * 1000));
+                }
+                result.principalVariation.push_back((*arena)[best].move);
+                current = best;
+            }
+            if (!result.principalVariation.empty()) result.bestMove = result.principalVariation[0];
+            result.depth = int(result.principalVariation.size());
+            lastStats.depth = result.depth;
+            return result;
+        }
+    };
+
+    SearchResult MacananGameState::makeAIMove(AIEngine& engine, const SearchLimits& limits) {
+        auto start = chrono::steady_clock::now();
+        SearchResult result = engine.search(*this, limits);
+        playAIMove(result, elapsedMilliseconds(start));
+        return result;
+    }
+
+    void MacananGameState::playAIMove(const SearchResult& result, double milliseconds) {
+        if (result.bestMove == NO_MOVE) return;
+
+        Position to = cellPosition(result.bestMove.to);
+        if (result.bestMove.from == NO_CELL) {
+            addPiece(aiPlayer, to.x, to.y);
+            cout << "AI places " << aiPlayer << " at (" << to.x << "," << to.y << ")" << endl;
+        } else {
+            Position from = cellPosition(result.bestMove.from);
+            movePiece(from, to);
+            cout << "AI moves " << aiPlayer << " from (" << from.x << "," << from.y
+                 << ") to (" << to.x << "," << to.y << ")" << endl;
+        }
+
+        cout << "AI depth " << result.depth << ", score " << result.score << ", nodes " << result.nodes
+             << ", time " << fixed << setprecision(0) << milliseconds << " ms, PV:";
+        for (const Move& move : result.principalVariation) {
+            cout << " " << moveToString(move);
+        }
+        cout << endl;
+    }
+
+    // Satu baris JSON untuk keputusan langkah di position (sebelum langkah dijalankan);
+    // extra berisi field tambahan yang sudah berformat, masing-masing diakhiri koma
+    string moveStatsJson(const MacananGameState& position, const SearchResult& result, const MoveStats& stats,
+                         double milliseconds, const string& engine, const string& extra = "") {
+        ostringstream json;
+        json << fixed << setprecision(3);
+        json << "{" << extra << "\"side\":\"" << sideName(position.getSideToMove()) << "\",\"phase\":\""
+             << position.getGamePhase() << "\",\"engine\":\"" << engine << "\",\"move\":\""
+             << (result.bestMove == NO_MOVE ? "" : moveToString(result.bestMove)) << "\",\"score\":" << result.score
+             << ",\"depth\":" << stats.depth << ",\"threads\":" << stats.threads << ",\"nodes\":" << stats.nodes
+             << ",\"nps\":" << uint64_t(stats.nodes / max(milliseconds / 1000.0, 1e-6))
+             << ",\"time_ms\":" << milliseconds << ",\"book_ms\":" << stats.bookMs
+             << ",\"search_ms\":" << stats.searchMs << ",\"stop_ms\":" << stats.stopMs;
+        if (stats.treeNodes > 0) json << ",\"tree_nodes\":" << stats.treeNodes;
+    #if MACANAN_STATS
+        const SearchStats& search = stats.search;
+        json << ",\"qnodes\":" << search.quiescenceNodes << ",\"evals\":" << search.evaluations
+             << ",\"moves_generated\":" << search.generatedMoves << ",\"tt_probes\":" << search.ttProbes
+             << ",\"tt_hits\":" << search.ttHits << ",\"tt_cutoffs\":" << search.ttCutoffs
+             << ",\"tb_hits\":" << search.tablebaseHits << ",\"cutoffs_by_index\":[";
+        for (int i = 0; i < STATS_CUTOFF_SLOTS; i++) json << (i > 0 ? "," : "") << search.cutoffsByIndex[i];
+        json << "],\"ebf\":" << stats.effectiveBranching;
+    #endif
+        json << "}";
+        return json.str();
+    }
+
+    // Berkas log instrumentasi (JSON lines), bisa ditulis banyak thread sekaligus
+    class StatsLog {
+    private:
+        FILE* output;
+        mutex lock;
+
+    public:
+        StatsLog() : output(nullptr) {}
+
+        ~StatsLog() {
+            if (output != nullptr) fclose(output);
+        }
+
+        bool open(const string& path) {
+            output = fopen(path.c_str(), "a");
+            return output != nullptr;
+        }
+
+        bool isOpen() const {
+            return output != nullptr;
+        }
+
+        void write(const string& line) {
+            lock_guard<mutex> guard(lock);
+            fputs(line.c_str(), output);
+            fputc('\n', output);
+            fflush(output);
+        }
+    };
+
+    // Berpikir di waktu lawan: selagi main menunggu input, satu thread mencari posisi
+    // setelah balasan yang diperkirakan (langkah kedua PV) dan mengisi TT/pohon engine.
+    class Ponderer {
+    private:
+        AIEngine* engine;
+        thread worker;
+        atomic<bool> finished;
+        MacananGameState position;
+        SearchResult result;
+        chrono::steady_clock::time_point startTime;
+        double ponderMs;
+
+    public:
+        Ponderer() : engine(nullptr), finished(true), result{NO_MOVE, 0, 0, 0, {}}, ponderMs(0) {}
+
+        ~Ponderer() {
+            cancel();
+        }
+
+        // Mulai pondering dari state setelah predicted, jika langkah itu sah. limits sama dengan
+        // pencarian biasa, jadi pondering berhenti sendiri begitu langkahnya sudah siap dimainkan.
+        void start(AIEngine& ponderEngine, const MacananGameState& state, const Move& predicted,
+                   const SearchLimits& limits) {
+            cancel();
+            MoveList moves;
+            state.generateMoves(moves);
+            if (find(moves.begin(), moves.end(), predicted) == moves.end()) return;
+
+            engine = &ponderEngine;
+            position = state;
+            position.makeMove(predicted);
+            position.clearUndoStack();
+            result = SearchResult{NO_MOVE, 0, 0, 0, {}};
+            finished.store(false);
+            startTime = chrono::steady_clock::now();
+            worker = thread([this, limits]() {
+                result = engine->search(position, limits);
+                finished.store(true);
+            });
+        }
+
+        // Hentikan pondering dan tunggu thread-nya; aman dipanggil kapan saja
+        void cancel() {
+            if (!worker.joinable()) return;
+            // stop() bisa datang sebelum search() sempat mulai, jadi diulang sampai selesai
+            while (!finished.load()) {
+                engine->stop();
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            worker.join();
+            ponderMs = elapsedMilliseconds(startTime);
+        }
+
+        // Selesaikan pondering untuk posisi actual. True jika perkiraan tepat dan hasil
+        // pondering sudah memenuhi limits (atau pencariannya selesai sendiri), sehingga
+        // langkahnya bisa langsung dimainkan.
+        bool finish(const MacananGameState& actual, const SearchLimits& limits) {
+            bool active = worker.joinable();
+            bool completed = finished.load();
+            cancel();
+            if (!active || actual.getHashKey() != position.getHashKey() || result.bestMove == NO_MOVE) return false;
+            return completed ||
+                   (limits.depth > 0 && result.depth >= limits.depth) ||
+                   (limits.nodes > 0 && result.nodes >= limits.nodes) ||
+                   (limits.timeMs > 0 && ponderMs >= limits.timeMs);
+        }
+
+        const SearchResult& getResult() const {
+            return result;
+        }
+    };
+
+    // Nilai opsi "--nama N" dari argumen baris perintah, atau defaultValue jika tidak ada
+    int optionValue(int argc, char* argv[], const string& name, int defaultValue) {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (argv[i] == name) return atoi(argv[i + 1]);
+        }
+        return defaultValue;
+    }
+
+    // Posisi uji yang sama setiap kali: langkah acak dengan seed tetap dari posisi awal
+    vector<MacananGameState> benchmarkPositions() {
+        vector<MacananGameState> positions;
+        mt19937 rng(20240601);
+        for (int plies : {2, 6, 10, 14, 20, 28}) {
+            MacananGameState state;
+            for (int i = 0; i < plies && !state.isUwongDefeated(); i++) {
+                MoveList moves;
+                state.generateMoves(moves);
+                if (moves.empty()) break;
+                state.makeMove(moves[rng() % moves.size()]);
+            }
+            state.clearUndoStack();
+            positions.push_back(state);
+        }
+        return positions;
+    }
+
+    // Nilai opsi "--nama teks", atau defaultValue jika tidak ada
+    string optionString(int argc, char* argv[], const string& name, const string& defaultValue) {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (argv[i] == name) return argv[i + 1];
+        }
+        return defaultValue;
+    }
+
+    bool hasOption(int argc, char* argv[], const string& name) {
+        for (int i = 1; i < argc; i++) {
+            if (argv[i] == name) return true;
+        }
+        return false;
+    }
+
+    // Opsi --tablebase FILE: muat tablebase; false jika opsi ada tapi berkas tidak bisa dibaca
+    bool loadTablebaseOption(int argc, char* argv[], EndgameTablebase& tablebase) {
+        string path = optionString(argc, argv, "--tablebase", "");
+        if (path.empty()) return true;
+        if (!tablebase.load(path)) {
+            cerr << "Cannot load tablebase " << path << " (missing, corrupt, or built for another --min-uwong)" << endl;
+            return false;
+        }
+        cout << "Tablebase " << path << " loaded (up to " << tablebase.getMaxUwong() << " uwong)" << endl;
+        return true;
+    }
+
+    // Opsi --book FILE: muat buku pembukaan; false jika opsi ada tapi berkas tidak bisa dibaca
+    bool loadBookOption(int argc, char* argv[], OpeningBook& book) {
+        string path = optionString(argc, argv, "--book", "");
+        if (path.empty()) return true;
+        if (!book.load(path)) {
+            cerr << "Cannot load opening book " << path << endl;
+            return false;
+        }
+        cout << "Opening book " << path << " loaded (" << book.size() << " positions)" << endl;
+        return true;
+    }
+
+    // Opsi --nnue FILE (dengan akhiran engine, misalnya --nnue-a): muat bobot NNUE;
+    // false jika opsi ada tapi berkas tidak bisa dibaca
+    bool loadNetworkOption(int argc, char* argv[], const string& suffix, NnueNetwork& network) {
+        string path = optionString(argc, argv, "--nnue" + suffix, "");
+        if (path.empty()) return true;
+        if (!network.load(path)) {
+            cerr << "Cannot load NNUE weights " << path << endl;
+            return false;
+        }
+        cout << "NNUE weights " << path << " loaded" << endl;
+        return true;
+    }
+
+    // Jumlah posisi daun tepat depth langkah dari state (posisi akhir permainan tidak diteruskan)
+    uint64_t perft(MacananGameState& state, int depth) {
+        if (depth == 0) return 1;
+        if (state.isUwongDefeated()) return 0;
+
+        MoveList moves;
+        state.generateMoves(moves);
+        if (depth == 1) return moves.size();
+
+        uint64_t leaves = 0;
+        for (const Move& move : moves) {
+            state.makeMove(move);
+            leaves += perft(state, depth - 1);
+            state.unmakeMove();
+        }
+        return leaves;
+    }
+
+    // Mode perft: macanan perft DEPTH [--position "TEKS"] [--divide]
+    int runPerft(int argc, char* argv[]) {
+        int depth = argc > 2 ? atoi(argv[2]) : 0;
+        if (depth < 1 || depth >= UNDO_STACK_SIZE) {
+            cout << "Usage: macanan perft DEPTH [--position \"POSITION\"] [--divide]" << endl;
+            return 1;
+        }
+
+        MacananGameState state;
+        string position = optionString(argc, argv, "--position", "");
+        if (!position.empty() && !state.setPosition(position)) {
+            cout << "Invalid position: " << position << endl;
+            return 1;
+        }
+        cout << "Position: " << state.toPositionString() << endl;
+
+        uint64_t leaves = 0;
+        auto start = chrono::steady_clock::now();
+        if (hasOption(argc, argv, "--divide") && !state.isUwongDefeated()) {
+            // Rincian per langkah akar
+            MoveList moves;
+            state.generateMoves(moves);
+            for (const Move& move : moves) {
+                state.makeMove(move);
+                uint64_t count = perft(state, depth - 1);
+                state.unmakeMove();
+                cout << moveToString(move) << ": " << count << endl;
+                leaves += count;
+            }
+        } else {
+            leaves = perft(state, depth);
+        }
+        double milliseconds = elapsedMilliseconds(start);
+
+        cout << "Depth " << depth << ": " << leaves << " nodes, "
+             << fixed << setprecision(1) << milliseconds << " ms, "
+             << setprecision(0) << leaves / max(milliseconds / 1000.0, 1e-9) << " nps" << endl;
+        return 0;
+    }
+
+    // Pengaturan satu engine AI
+    struct EngineSettings {
+        int depth;          // 0: tanpa batas kedalaman (dibatasi waktu/node)
+        int hashMegabytes;
+        bool mcts;          // MctsEngine, bukan SearchEngine
+        int nodes;          // batas node per langkah (playout untuk MCTS), 0 tanpa batas
+        int moveTimeMs;     // waktu tetap per langkah, 0 tanpa batas
+        int clockMs;        // jam permainan; jika ada, menggantikan moveTimeMs
+        int incrementMs;    // tambahan waktu setiap langkah selesai
+    };
+
+    // Opsi engine dengan akhiran suffix ("", "-a", "-b"): --engine alphabeta|mcts, --depth,
+    // --nodes (atau --playouts), --movetime MS, --clock MS, --increment MS; --hash berlaku
+    // untuk semua engine. Tanpa batas waktu/node, kedalaman default adalah defaultDepth.
+    EngineSettings engineOptions(int argc, char* argv[], const string& suffix, int defaultDepth, int hashMegabytes) {
+        EngineSettings settings;
+        settings.hashMegabytes = hashMegabytes;
+        settings.mcts = optionString(argc, argv, "--engine" + suffix, "alphabeta") == "mcts";
+        settings.nodes = max(0, optionValue(argc, argv, "--nodes" + suffix,
+                                            optionValue(argc, argv, "--playouts" + suffix, 0)));
+        settings.moveTimeMs = max(0, optionValue(argc, argv, "--movetime" + suffix, 0));
+        settings.clockMs = max(0, optionValue(argc, argv, "--clock" + suffix, 0));
+        settings.incrementMs = max(0, optionValue(argc, argv, "--increment" + suffix, 0));
+        bool budgeted = settings.nodes > 0 || settings.moveTimeMs > 0 || settings.clockMs > 0;
+        settings.depth = max(0, optionValue(argc, argv, "--depth" + suffix, budgeted ? 0 : defaultDepth));
+        return settings;
+    }
+
+    string engineName(const EngineSettings& settings) {
+        string name = settings.mcts ? "mcts" : "alphabeta";
+        if (!settings.mcts && settings.depth > 0) name += " depth " + to_string(settings.depth);
+        if (settings.nodes > 0) name += " " + to_string(settings.nodes) + (settings.mcts ? " playouts" : " nodes");
+        if (settings.clockMs > 0) {
+            name += " clock " + to_string(settings.clockMs) + "+" + to_string(settings.incrementMs) + " ms";
+        } else if (settings.moveTimeMs > 0) {
+            name += " " + to_string(settings.moveTimeMs) + " ms/move";
+        }
+        return name;
+    }
+
+    // Jam permainan: sisa waktu dibagi ke perkiraan jumlah langkah yang masih tersisa
+    const double CLOCK_MOVES_TO_GO = 30;
+    const double CLOCK_INCREMENT_SHARE = 0.8;
+    const double CLOCK_RESERVE_MS = 10;   // cadangan untuk kerja di luar pencarian
+
+    class GameClock {
+    private:
+        double remainingMs;
+        double incrementMs;
+        bool enabled;
+
+    public:
+        GameClock(double totalMs, double incrementMs)
+            : remainingMs(totalMs), incrementMs(incrementMs), enabled(totalMs > 0) {}
+
+        bool isEnabled() const {
+            return enabled;
+        }
+
+        // Jatah waktu langkah berikutnya; tidak pernah lebih dari separuh sisa waktu
+        double allocate() const {
+            double share = remainingMs / CLOCK_MOVES_TO_GO + incrementMs * CLOCK_INCREMENT_SHARE;
+            double ceiling = remainingMs / 2 - CLOCK_RESERVE_MS;
+            return max(1.0, min(share, ceiling));
+        }
+
+        void consume(double usedMs) {
+            remainingMs -= usedMs;
+            if (remainingMs >= 0) remainingMs += incrementMs;
+        }
+
+        bool isFlagged() const {
+            return enabled && remainingMs < 0;
+        }
+
+        double getRemaining() const {
+            return remainingMs;
+        }
+    };
+
+    // Batas pencarian langkah berikutnya: dari jam permainan jika ada, kalau tidak dari pengaturan tetap
+    SearchLimits moveLimits(const EngineSettings& settings, const GameClock& clock) {
+        double timeMs = clock.isEnabled() ? clock.allocate() : settings.moveTimeMs;
+        return SearchLimits{settings.depth, timeMs, uint64_t(settings.nodes)};
+    }
+
+    // Tablebase, buku, dan network (boleh nullptr) hanya dipakai engine alpha-beta;
+    // MCTS memakai playout acak tanpa evaluasi statis
+    unique_ptr<AIEngine> createEngine(const EngineSettings& settings, int threads, const EndgameTablebase* tablebase,
+                                      const OpeningBook* book, const NnueNetwork* network) {
+        if (settings.mcts) {
+            return unique_ptr<AIEngine>(new MctsEngine(threads));
+        }
+        SearchEngine* engine = new SearchEngine(settings.depth > 0 ? settings.depth : MAX_PLY - 1,
+                                                settings.hashMegabytes);
+        engine->setThreadCount(threads);
+        engine->setTablebase(tablebase);
+        engine->setBook(book);
+        engine->setNetwork(network);
+        return unique_ptr<AIEngine>(engine);
+    }
+
+    enum GameOutcome {
+        OUTCOME_DRAW,
+        OUTCOME_MACAN_WIN,
+        OUTCOME_UWONG_WIN
+    };
+
+    // Permainan dianggap seri jika belum selesai setelah sekian ply
+    const int SELFPLAY_MAX_PLIES = 300;
+
+    // Posisi yang sama muncul sekian kali dalam satu permainan: seri
+    const int SELFPLAY_REPETITIONS = 3;
+
+    // Sebab permainan headless berakhir
+    enum GameEnding {
+        ENDING_RULES,         // Uwong habis atau pemain jalan tidak punya langkah
+        ENDING_TIME,          // jam habis
+        ENDING_REPETITION,
+        ENDING_ADJUDICATION,  // kedua engine sepakat soal pemenang
+        ENDING_TABLEBASE,
+        ENDING_MAX_PLIES,
+        GAME_ENDING_COUNT
+    };
+
+    const char* const GAME_ENDING_NAMES[GAME_ENDING_COUNT] = {
+        "rules", "time", "repetition", "adjudication", "tablebase", "ply cap"
+    };
+
+    // Aturan mengakhiri permainan lebih awal. Adjudikasi: selama plies ply berturut-turut skor
+    // setiap pemain jalan (dari sisinya sendiri) menyatakan pemenang yang sama dengan |skor| >= score.
+    // Default score WIN_THRESHOLD hanya menerima kemenangan yang sudah terlihat pasti oleh engine.
+    struct Adjudication {
+        int score;
+        int plies;                            // 0: tanpa adjudikasi skor
+        const EndgameTablebase* tablebase;    // posisi yang tercakup langsung diputuskan tablebase
+    };
+
+    // Pembuka acak yang sama untuk sepasang permainan (warna ditukar), ditentukan oleh seed
+    MacananGameState randomOpening(uint32_t seed, int plies) {
+        MacananGameState state;
+        mt19937 rng(seed);
+        for (int i = 0; i < plies && !state.isUwongDefeated(); i++) {
+            MoveList moves;
+            state.generateMoves(moves);
+            if (moves.empty()) break;
+            state.makeMove(moves[rng() % moves.size()]);
+        }
+        state.clearUndoStack();
+        return state;
+    }
+
+    // Satu posisi dataset beserta hasil permainannya, 16 byte. Papan disimpan per nomor urut
+    // sel yang bisa dimainkan (37 bit); sisa bit macans memuat giliran, hasil, dan sisa penempatan.
+    struct DatasetRecord {
+        uint64_t macans;
+        uint64_t uwongs;
+    };
+
+    static_assert(sizeof(DatasetRecord) == 16, "Format dataset mengandalkan rekaman 16 byte");
+
+    const int DATASET_SIDE_SHIFT = PLAYABLE_CELL_COUNT;              // 1 bit: Uwong jalan
+    const int DATASET_RESULT_SHIFT = DATASET_SIDE_SHIFT + 1;         // 2 bit: 0 Uwong menang, 1 seri, 2 Macan menang
+    const int DATASET_MACAN_LEFT_SHIFT = DATASET_RESULT_SHIFT + 2;   // 2 bit
+    const int DATASET_UWONG_LEFT_SHIFT = DATASET_MACAN_LEFT_SHIFT + 2;
+
+    static_assert(DATASET_UWONG_LEFT_SHIFT + 4 <= 64, "Rekaman dataset tidak muat dalam 64 bit");
+
+    struct DatasetHeader {
+        char magic[4];        // "MCDS"
+        uint32_t version;
+        uint32_t recordSize;  // sizeof(DatasetRecord)
+        uint32_t reserved;
+    };
+
+    const uint32_t DATASET_VERSION = 1;
+
+    inline uint64_t compressBoard(Bitboard board) {
+        uint64_t bits = 0;
+        while (board) bits |= uint64_t(1) << PLAYABLE_ORDER.orderOf[popLowestCell(board)];
+        return bits;
+    }
+
+    inline Bitboard expandBoard(uint64_t bits) {
+        Bitboard board = 0;
+        while (bits) board |= Bitboard(1) << PLAYABLE_ORDER.cellOf[popLowestCell(bits)];
+        return board;
+    }
+
+    // Rekaman untuk state; hasil diisi setelah permainan selesai dengan setDatasetResult
+    inline DatasetRecord makeDatasetRecord(const MacananGameState& state) {
+        DatasetRecord record;
+        record.macans = compressBoard(state.getMacanBoard()) |
+                        uint64_t(state.getSideToMove()) << DATASET_SIDE_SHIFT |
+                        uint64_t(state.getRemainingMacan()) << DATASET_MACAN_LEFT_SHIFT |
+                        uint64_t(state.getRemainingUwong()) << DATASET_UWONG_LEFT_SHIFT;
+        record.uwongs = compressBoard(state.getUwongBoard());
+        return record;
+    }
+
+    inline void setDatasetResult(DatasetRecord& record, GameOutcome outcome) {
+        uint64_t result = outcome == OUTCOME_MACAN_WIN ? 2 : outcome == OUTCOME_DRAW ? 1 : 0;
+        record.macans = (record.macans & ~(uint64_t(3) << DATASET_RESULT_SHIFT)) | result << DATASET_RESULT_SHIFT;
+    }
+
+    // Skor hasil bagi Macan: 1 menang, 0.5 seri, 0 kalah
+    inline double datasetResult(const DatasetRecord& record) {
+        return ((record.macans >> DATASET_RESULT_SHIFT) & 3) / 2.0;
+    }
+
+    inline Bitboard datasetMacans(const DatasetRecord& record) {
+        return expandBoard(record.macans & ((uint64_t(1) << PLAYABLE_CELL_COUNT) - 1));
+    }
+
+    inline Bitboard datasetUwongs(const DatasetRecord& record) {
+        return expandBoard(record.uwongs);
+    }
+
+    // Penulis dataset yang dipakai bersama banyak thread; rekaman ditambahkan di akhir berkas
+    class DatasetWriter {
+    private:
+        FILE* output;
+        mutex lock;
+        uint64_t written;
+
+    public:
+        DatasetWriter() : output(nullptr), written(0) {}
+
+        ~DatasetWriter() {
+            if (output != nullptr) fclose(output);
+        }
+
+        // Buka path untuk ditambahi; berkas baru diberi header, berkas lama harus berformat sama
+        bool open(const string& path) {
+            DatasetHeader header = {};
+            memcpy(header.magic, "MCDS", 4);
+            header.version = DATASET_VERSION;
+            header.recordSize = sizeof(DatasetRecord);
+
+            FILE* existing = fopen(path.c_str(), "rb");
+            if (existing != nullptr) {
+                DatasetHeader found;
+                bool valid = fread(&found, sizeof(found), 1, existing) == 1 && memcmp(&found, &header, sizeof(header)) == 0;
+                fclose(existing);
+                if (!valid) return false;
+                output = fopen(path.c_str(), "ab");
+                return output != nullptr;
+            }
+            output = fopen(path.c_str(), "wb");
+            return output != nullptr && fwrite(&header, sizeof(header), 1, output) == 1;
+        }
+
+        bool isOpen() const {
+            return output != nullptr;
+        }
+
+        void append(const vector<DatasetRecord>& records) {
+            lock_guard<mutex> guard(lock);
+            written += fwrite(records.data(), sizeof(DatasetRecord), records.size(), output);
+        }
+
+        uint64_t getWritten() const {
+            return written;
+        }
+    };
+
+    // Satu sisi dalam permainan headless: engine, pengaturannya, jam, dan langkah terlamanya
+    struct GamePlayer {
+        AIEngine* engine;
+        EngineSettings settings;
+        GameClock clock;
+        double longestMoveMs;
+    };
+
+    // Satu permainan engine vs engine tanpa output; plies diisi panjang permainan dan ending
+    // sebab berakhirnya. Pemain yang kehabisan jam kalah. Jika records tidak nullptr, setiap posisi
+    // sebelum langkah dicatat di sana (tanpa hasil).
+    GameOutcome playHeadlessGame(MacananGameState state, GamePlayer& macan, GamePlayer& uwong, int& plies,
+                                 GameEnding& ending, const Adjudication& adjudication,
+                                 vector<DatasetRecord>* records = nullptr, StatsLog* statsLog = nullptr, int game = 0) {
+        uint64_t history[SELFPLAY_MAX_PLIES];
+        int agreedPlies = 0;
+        GameOutcome agreed = OUTCOME_DRAW;
+        ending = ENDING_RULES;
+        for (plies = 0; plies < SELFPLAY_MAX_PLIES; plies++) {
+            if (state.isUwongDefeated()) return OUTCOME_MACAN_WIN;
+
+            GameOutcome win = state.getSideToMove() == SIDE_MACAN ? OUTCOME_MACAN_WIN : OUTCOME_UWONG_WIN;
+            GameOutcome loss = state.getSideToMove() == SIDE_MACAN ? OUTCOME_UWONG_WIN : OUTCOME_MACAN_WIN;
+            if (adjudication.tablebase != nullptr && adjudication.tablebase->covers(state)) {
+                uint8_t value = adjudication.tablebase->probe(state);
+                ending = ENDING_TABLEBASE;
+                return value == TB_DRAW ? OUTCOME_DRAW : value % 2 == 1 ? win : loss;
+            }
+            history[plies] = state.getHashKey();
+            if (count(history, history + plies + 1, history[plies]) >= SELFPLAY_REPETITIONS) {
+                ending = ENDING_REPETITION;
+                return OUTCOME_DRAW;
+            }
+            if (records != nullptr) records->push_back(makeDatasetRecord(state));
+
+            GamePlayer& player = state.getSideToMove() == SIDE_MACAN ? macan : uwong;
+            auto start = chrono::steady_clock::now();
+            SearchResult result = player.engine->search(state, moveLimits(player.settings, player.clock));
+            double milliseconds = elapsedMilliseconds(start);
+            player.longestMoveMs = max(player.longestMoveMs, milliseconds);
+            if (statsLog != nullptr) {
+                string fields = "\"game\":" + to_string(game) + ",\"ply\":" + to_string(plies) + ",";
+                statsLog->write(moveStatsJson(state, result, player.engine->getMoveStats(), milliseconds,
+                                              engineName(player.settings), fields));
+            }
+            player.clock.consume(milliseconds);
+            if (player.clock.isFlagged()) {
+                ending = ENDING_TIME;
+                return loss;
+            }
+
+            if (result.bestMove == NO_MOVE) {
+                // Pemain jalan tidak punya langkah sah: kalah
+                return loss;
+            }
+
+            // Kedua pemain harus bergantian menyatakan pemenang yang sama
+            GameOutcome claimed = result.score >= adjudication.score ? win
+                                : result.score <= -adjudication.score ? loss : OUTCOME_DRAW;
+            agreedPlies = claimed != OUTCOME_DRAW && claimed == agreed ? agreedPlies + 1 : 1;
+            agreed = claimed;
+            if (adjudication.plies > 0 && agreed != OUTCOME_DRAW && agreedPlies >= adjudication.plies) {
+                ending = ENDING_ADJUDICATION;
+                return agreed;
+            }
+
+            state.makeMove(result.bestMove);
+            state.clearUndoStack();
+        }
+        ending = ENDING_MAX_PLIES;
+        return OUTCOME_DRAW;
+    }
+
+    // Mode selfplay: turnamen engine A vs engine B, banyak permainan paralel tanpa output per langkah
+    int runSelfPlay(int argc, char* argv[]) {
+        int games = max(2, optionValue(argc, argv, "--games", 1000));
+        int threads = max(1, optionValue(argc, argv, "--threads", int(thread::hardware_concurrency())));
+        int openingPlies = max(0, optionValue(argc, argv, "--opening-plies", 4));
+        uint32_t seed = uint32_t(optionValue(argc, argv, "--seed", 1));
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 4));
+        // --adjudicate-score S --adjudicate-plies N: akhiri permainan yang sudah jelas pemenangnya
+        Adjudication adjudication;
+        adjudication.score = max(1, optionValue(argc, argv, "--adjudicate-score", WIN_THRESHOLD));
+        adjudication.plies = max(0, optionValue(argc, argv, "--adjudicate-plies", 2));
+        EngineSettings settingsA = engineOptions(argc, argv, "-a", 4, hashMegabytes);
+        EngineSettings settingsB = engineOptions(argc, argv, "-b", 4, hashMegabytes);
+        EndgameTablebase tablebase;
+        if (!loadTablebaseOption(argc, argv, tablebase)) return 1;
+        OpeningBook book;
+        if (!loadBookOption(argc, argv, book)) return 1;
+        adjudication.tablebase = tablebase.isLoaded() ? &tablebase : nullptr;
+        NnueNetwork networkA, networkB;
+        if (!loadNetworkOption(argc, argv, "-a", networkA) || !loadNetworkOption(argc, argv, "-b", networkB)) return 1;
+        // --stats FILE: satu baris JSON instrumentasi per langkah
+        StatsLog statsLog;
+        string statsPath = optionString(argc, argv, "--stats", "");
+        if (!statsPath.empty() && !statsLog.open(statsPath)) {
+            cerr << "Cannot open stats log " << statsPath << endl;
+            return 1;
+        }
+        // --dataset FILE: semua posisi permainan beserta hasilnya, untuk mode tune
+        DatasetWriter dataset;
+        string datasetPath = optionString(argc, argv, "--dataset", "");
+        if (!datasetPath.empty() && !dataset.open(datasetPath)) {
+            cerr << "Cannot open dataset " << datasetPath << endl;
+            return 1;
+        }
+
+        // Statistik dari sudut pandang engine A
+        atomic<int> nextGame(0);
+        atomic<int> wins(0), draws(0), losses(0), macanWins(0);
+        atomic<long long> totalPlies(0);
+        atomic<int> shortestGame(SELFPLAY_MAX_PLIES), longestGame(0);
+        atomic<int> endings[GAME_ENDING_COUNT] = {};
+        atomic<long long> longestMoveMicros(0);
+
+        auto worker = [&]() {
+            const EndgameTablebase* sharedTablebase = tablebase.isLoaded() ? &tablebase : nullptr;
+            const OpeningBook* sharedBook = book.isLoaded() ? &book : nullptr;
+            unique_ptr<AIEngine> engineA = createEngine(settingsA, 1, sharedTablebase, sharedBook,
+                                                        networkA.isLoaded() ? &networkA : nullptr);
+            unique_ptr<AIEngine> engineB = createEngine(settingsB, 1, sharedTablebase, sharedBook,
+                                                        networkB.isLoaded() ? &networkB : nullptr);
+
+            vector<DatasetRecord> records;
+            for (int game = nextGame++; game < games; game = nextGame++) {
+                // Permainan genap: A sebagai Macan; ganjil: warna ditukar dengan pembuka yang sama
+                bool aIsMacan = game % 2 == 0;
+                MacananGameState start = randomOpening(seed + uint32_t(game / 2), openingPlies);
+                engineA->newGame();
+                engineB->newGame();
+
+                GamePlayer playerA = {engineA.get(), settingsA, GameClock(settingsA.clockMs, settingsA.incrementMs), 0};
+                GamePlayer playerB = {engineB.get(), settingsB, GameClock(settingsB.clockMs, settingsB.incrementMs), 0};
+                int plies = 0;
+                GameEnding ending;
+                records.clear();
+                vector<DatasetRecord>* gameRecords = dataset.isOpen() ? &records : nullptr;
+                StatsLog* gameLog = statsLog.isOpen() ? &statsLog : nullptr;
+                GameOutcome outcome = aIsMacan
+                    ? playHeadlessGame(start, playerA, playerB, plies, ending, adjudication, gameRecords, gameLog, game)
+                    : playHeadlessGame(start, playerB, playerA, plies, ending, adjudication, gameRecords, gameLog, game);
+                if (gameRecords != nullptr) {
+                    for (DatasetRecord& record : records) setDatasetResult(record, outcome);
+                    dataset.append(records);
+                }
+                endings[ending]++;
+
+                long long longestMove = llround(max(playerA.longestMoveMs, playerB.longestMoveMs) * 1000);
+                for (long long seen = longestMoveMicros.load();
+                     longestMove > seen && !longestMoveMicros.compare_exchange_weak(seen, longestMove); ) {}
+
+                if (outcome == OUTCOME_DRAW) {
+                    draws++;
+                } else {
+                    if (outcome == OUTCOME_MACAN_WIN) macanWins++;
+                    bool aWon = (outcome == OUTCOME_MACAN_WIN) == aIsMacan;
+                    (aWon ? wins : losses)++;
+                }
+
+                totalPlies += plies;
+                for (int seen = shortestGame.load(); plies < seen && !shortestGame.compare_exchange_weak(seen, plies); ) {}
+                for (int seen = longestGame.load(); plies > seen && !longestGame.compare_exchange_weak(seen, plies); ) {}
+            }
+        };
+
+        cout << "Self-play: " << games << " games on " << threads << " threads, A "
+             << engineName(settingsA) << " vs B " << engineName(settingsB) << endl;
+        cout << "Rules: " << RULES.describe() << endl;
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> pool;
+        for (int i = 0; i < threads; i++) pool.emplace_back(worker);
+        for (thread& t : pool) t.join();
+        double seconds = elapsedMilliseconds(start) / 1000.0;
+
+        // Elo dari skor rata-rata, galat 95% dari simpangan baku skor per permainan
+        double n = games;
+        double w = wins / n, d = draws / n, l = losses / n;
+        double score = w + d / 2;
+        double variance = w * (1 - score) * (1 - score) + d * (0.5 - score) * (0.5 - score) + l * score * score;
+        double margin = 1.96 * sqrt(variance / n);
+        auto eloFromScore = [](double s) {
+            s = min(max(s, 1e-6), 1 - 1e-6);
+            return -400.0 * log10(1.0 / s - 1.0);
+        };
+        double elo = eloFromScore(score);
+
+        cout << "A wins " << wins << ", draws " << draws << ", losses " << losses
+             << " (macan won " << macanWins << " of " << games << ")" << endl;
+        cout << "Game length: avg " << fixed << setprecision(1) << totalPlies / n
+             << " plies, min " << shortestGame << ", max " << longestGame << endl;
+        cout << "Longest move: " << longestMoveMicros / 1000.0 << " ms" << endl;
+        cout << "Ended by:";
+        for (int i = 0; i < GAME_ENDING_COUNT; i++) {
+            cout << (i > 0 ? "," : "") << " " << GAME_ENDING_NAMES[i] << " " << endings[i];
+        }
+        cout << endl;
+        if (endings[ENDING_MAX_PLIES] * 2 > games) {
+            cout << "Warning: most games hit the " << SELFPLAY_MAX_PLIES << "-ply cap; results say little" << endl;
+        }
+        cout << "Elo A - B: " << setprecision(1) << elo << " +/- "
+             << (eloFromScore(score + margin) - eloFromScore(score - margin)) / 2 << " (95%)" << endl;
+        cout << "Time: " << setprecision(2) << seconds << " s, "
+             << games / max(seconds, 1e-9) << " games/s" << endl;
+        if (dataset.isOpen()) cout << "Dataset " << datasetPath << ": " << dataset.getWritten() << " positions added" << endl;
+        return 0;
+    }
+
+    // Mode tbgen: hitung tablebase akhir permainan fase MOVING dan tulis ke berkas.
+    // macanan tbgen [--max-uwong N] [--threads N] [--output FILE]; N paling banyak
+    // TABLEBASE_MAX_UWONG (7), karena indeks 8 Uwong tidak muat di uint32_t
+    int runTablebaseGeneration(int argc, char* argv[]) {
+        int requested = optionValue(argc, argv, "--max-uwong", 4);
+        int maxUwong = min(TABLEBASE_MAX_UWONG, max(RULES.minUwong, requested));
+        int threads = max(1, optionValue(argc, argv, "--threads", int(thread::hardware_concurrency())));
+        string path = optionString(argc, argv, "--output", DEFAULT_TABLEBASE_FILE);
+        if (requested > TABLEBASE_MAX_UWONG) {
+            cout << "--max-uwong is limited to " << TABLEBASE_MAX_UWONG << " (8 uwong needs 64-bit indices)" << endl;
+        }
+
+        uint64_t total = 0;
+        for (int k = RULES.minUwong; k <= maxUwong; k++) total += TablebaseIndex::size(k);
+        cout << "Tablebase " << RULES.minUwong << ".." << maxUwong << " uwong on " << threads << " threads, "
+             << total << " positions, about " << tablebaseWorkingMemory(maxUwong) / (1 << 20)
+             << " MB working memory" << endl;
+
+        auto start = chrono::steady_clock::now();
+        TablebaseGenerator generator(threads);
+        if (!generator.generate(maxUwong, path, cout)) {
+            cerr << "Cannot write " << path << endl;
+            return 1;
+        }
+        cout << "Written " << path << " (" << sizeof(TablebaseHeader) + total << " bytes) in "
+             << fixed << setprecision(1) << elapsedMilliseconds(start) / 1000.0 << " s" << endl;
+        return 0;
+    }
+
+    // Posisi calon buku; trees berisi bit (1 << side) untuk buku pemain mana posisi ini dibutuhkan
+    struct BookNode {
+        MacananGameState state;
+        uint8_t trees;
+    };
+
+    // Mode bookgen: cari posisi awal fase PLACING secara mendalam dan tulis buku pembukaan.
+    // Di buku milik satu pemain, langkahnya sendiri hanya langkah terbaik, sedangkan semua
+    // balasan lawan diikuti; posisi satu level dicari paralel, satu engine per thread.
+    int runBookGeneration(int argc, char* argv[]) {
+        int plies = max(1, optionValue(argc, argv, "--plies", 6));
+        int depth = max(1, optionValue(argc, argv, "--depth", 8));
+        int threads = max(1, optionValue(argc, argv, "--threads", int(thread::hardware_concurrency())));
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 16));
+        string path = optionString(argc, argv, "--output", DEFAULT_BOOK_FILE);
+
+        cout << "Opening book: " << plies << " plies, depth " << depth << ", " << threads << " threads" << endl;
+
+        auto start = chrono::steady_clock::now();
+        vector<BookEntry> entries;
+        vector<BookNode> frontier = {{MacananGameState(), uint8_t(1 << SIDE_MACAN | 1 << SIDE_UWONG)}};
+        for (int ply = 0; ply < plies && !frontier.empty(); ply++) {
+            vector<SearchResult> results(frontier.size(), SearchResult{NO_MOVE, 0, 0, 0, {}});
+            atomic<size_t> nextNode(0);
+            atomic<int> searched(0);
+            auto worker = [&]() {
+                SearchEngine engine(depth, hashMegabytes);
+                for (size_t i = nextNode++; i < frontier.size(); i = nextNode++) {
+                    const BookNode& node = frontier[i];
+                    if (node.trees & (1 << node.state.getSideToMove())) {
+                        results[i] = engine.search(node.state);
+                        searched++;
+                    }
+                }
+            };
+            vector<thread> pool;
+            for (int i = 0; i < threads; i++) pool.emplace_back(worker);
+            for (thread& t : pool) t.join();
+
+            // Simpan langkah terbaik lalu bentuk level berikutnya (posisi cermin digabung)
+            vector<BookNode> nextFrontier;
+            unordered_map<uint64_t, size_t> seen;
+            for (size_t i = 0; i < frontier.size(); i++) {
+                const BookNode& node = frontier[i];
+                Side side = node.state.getSideToMove();
+                bool own = node.trees & (1 << side);
+                const SearchResult& result = results[i];
+                if (own && !(result.bestMove == NO_MOVE)) {
+                    int symmetry = node.state.getCanonicalSymmetry();
+                    Move move = mirrorMove(result.bestMove, symmetry);
+                    entries.push_back({node.state.getHashKey(symmetry), move.from, move.to, move.captured,
+                                       uint8_t(result.depth), int32_t(result.score)});
+                }
+
+                MoveList moves;
+                node.state.generateMoves(moves);
+                for (const Move& move : moves) {
+                    uint8_t trees = node.trees & (1 << opponentOf(side));
+                    if (own && move == result.bestMove) trees |= uint8_t(1 << side);
+                    if (trees == 0) continue;
+
+                    MacananGameState child = node.state;
+                    child.makeMove(move);
+                    child.clearUndoStack();
+                    auto found = seen.find(child.getCanonicalKey());
+                    if (found != seen.end()) {
+                        nextFrontier[found->second].trees |= trees;
+                    } else {
+                        seen.emplace(child.getCanonicalKey(), nextFrontier.size());
+                        nextFrontier.push_back({child, trees});
+                    }
+                }
+            }
+
+            cout << "Ply " << ply << ": " << frontier.size() << " positions, " << searched << " searched, "
+                 << fixed << setprecision(1) << elapsedMilliseconds(start) / 1000.0 << " s" << endl;
+            frontier.swap(nextFrontier);
+        }
+
+        sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) { return a.key < b.key; });
+        entries.erase(unique(entries.begin(), entries.end(),
+                             [](const BookEntry& a, const BookEntry& b) { return a.key == b.key; }),
+                      entries.end());
+
+        BookHeader header = {};
+        memcpy(header.magic, "MCBK", 4);
+        header.version = BOOK_VERSION;
+        header.count = entries.size();
+
+        FILE* output = fopen(path.c_str(), "wb");
+        bool ok = output != nullptr && fwrite(&header, sizeof(header), 1, output) == 1 &&
+                  fwrite(entries.data(), sizeof(BookEntry), entries.size(), output) == entries.size();
+        if (output != nullptr && fclose(output) != 0) ok = false;
+        if (!ok) {
+            cerr << "Cannot write " << path << endl;
+            return 1;
+        }
+        cout << "Written " << path << ": " << entries.size() << " entries ("
+             << sizeof(header) + entries.size() * sizeof(BookEntry) << " bytes)" << endl;
+        return 0;
+    }
+
+    // Mode smpbench: waktu mencapai kedalaman tetap untuk 1, 2, 4, ... thread
+    int runSmpBenchmark(int argc, char* argv[]) {
+        int depth = max(1, optionValue(argc, argv, "--depth", 9));
+        int maxThreads = max(1, optionValue(argc, argv, "--threads", 8));
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 64));
+        vector<MacananGameState> positions = benchmarkPositions();
+
+        cout << "Lazy SMP benchmark: " << positions.size() << " positions, depth " << depth
+             << ", hash " << hashMegabytes << " MB" << endl;
+        cout << setw(8) << "threads" << setw(12) << "time_ms" << setw(14) << "nodes"
+             << setw(12) << "knps" << setw(10) << "speedup" << endl;
+
+        double singleThreadTime = 0;
+        CutoffStats ordering = CutoffStats();
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            SearchEngine engine(depth, hashMegabytes);
+            engine.setThreadCount(threads);
+
+            uint64_t nodes = 0;
+            auto start = chrono::steady_clock::now();
+            for (const MacananGameState& position : positions) {
+                engine.clearHash();
+                nodes += engine.search(position).nodes;
+                if (threads == 1) ordering.add(engine.getCutoffStats());
+            }
+            double milliseconds = elapsedMilliseconds(start);
+            if (threads == 1) singleThreadTime = milliseconds;
+
+            cout << setw(8) << threads << setw(12) << fixed << setprecision(1) << milliseconds
+                 << setw(14) << nodes << setw(12) << setprecision(0) << nodes / max(milliseconds, 1e-3)
+                 << setw(10) << setprecision(2) << singleThreadTime / max(milliseconds, 1e-3) << endl;
+        }
+
+        // Kualitas urutan langkah pada 1 thread: persentase cutoff per jenis langkah
+        auto percent = [&](uint64_t count) { return 100.0 * count / max<uint64_t>(ordering.cutoffs, 1); };
+        cout << "Cutoffs: " << ordering.cutoffs << ", first move " << setprecision(1)
+             << percent(ordering.firstMoveCutoffs) << "%, hash/pv " << percent(ordering.byKind[KIND_HASH])
+             << "%, capture " << percent(ordering.byKind[KIND_CAPTURE]) << "%, killer "
+             << percent(ordering.byKind[KIND_KILLER]) << "%, history " << percent(ordering.byKind[KIND_QUIET])
+             << "%" << endl;
+        return 0;
+    }
+
+    // Histogram latensi dengan ember logaritmik (4 per kelipatan dua mikrodetik), tanpa alokasi
+    const int LATENCY_BUCKETS = 128;
+
+    class LatencyHistogram {
+    private:
+        atomic<uint64_t> buckets[LATENCY_BUCKETS];
+        atomic<uint64_t> total;
+
+        static double bucketLimit(int bucket) {
+            return (pow(2.0, (bucket + 1) / 4.0) - 1) / 1000.0;
+        }
+
+    public:
+        LatencyHistogram() : buckets(), total(0) {}
+
+        void record(double milliseconds) {
+            double micros = max(0.0, milliseconds * 1000.0);
+            int bucket = min(LATENCY_BUCKETS - 1, int(log2(micros + 1) * 4));
+            buckets[bucket].fetch_add(1, memory_order_relaxed);
+            total.fetch_add(1, memory_order_relaxed);
+        }
+
+        uint64_t count() const {
+            return total.load();
+        }
+
+        // Batas atas ember yang memuat persentil fraction (0..1), dalam milidetik; 0 jika kosong
+        double percentile(double fraction) const {
+            if (total.load() == 0) return 0;
+            uint64_t target = uint64_t(ceil(fraction * total.load())), seen = 0;
+            for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+                seen += buckets[bucket].load();
+                if (seen >= max<uint64_t>(target, 1)) return bucketLimit(bucket);
+            }
+            return bucketLimit(LATENCY_BUCKETS - 1);
+        }
+    };
+
+    enum SessionStatus : uint8_t {
+        SESSION_FREE,
+        SESSION_WAITING,     // menunggu langkah pemain
+        SESSION_THINKING,    // langkah AI antre atau sedang dicari
+        SESSION_OVER
+    };
+
+    // Satu permainan di host; ukurannya tetap, tanpa alokasi heap
+    struct Session {
+        MacananGameState state;
+        Side humanSide;
+        SessionStatus status;
+        bool closing;        // close datang saat AI berpikir; slot dibebaskan setelah selesai
+        int plies;
+        chrono::steady_clock::time_point requested;
+    };
+
+    // Keluaran protokol host: satu baris tanpa newline
+    typedef void (*HostOutput)(void* context, const char* line);
+
+    // Host banyak permainan manusia vs AI. Perintah (satu per baris):
+    //   new macan|uwong         -> "new ID" (AI langsung jalan jika giliran AI)
+    //   move ID X Y             penempatan;  move ID FX FY TX TY  geser/lompat
+    //                           -> "ai ID X Y" atau "ai ID FX FY TX TY", lalu "over ID PEMENANG" bila selesai
+    //   show ID                 -> "position ID TEKS";  close ID;  stats
+    // Galat dijawab "error ID PESAN". Sesi disimpan di slab berkapasitas tetap; langkah AI
+    // dijadwalkan FIFO ke worker pool dengan batas waktu/node yang sama untuk setiap langkah,
+    // dan setiap sesi paling banyak punya satu langkah di antrean.
+    class SessionHost {
+    private:
+        vector<Session> sessions;
+        vector<uint32_t> freeSlots;
+        vector<uint32_t> jobs;           // antrean melingkar nomor sesi
+        size_t jobHead;
+        size_t jobCount;
+        mutex lock;                      // status sesi, free list, dan antrean
+        condition_variable jobReady;
+        bool stopping;
+        vector<thread> workers;
+        EngineSettings settings;
+        const EndgameTablebase* tablebase;
+        const OpeningBook* book;
+        const NnueNetwork* network;
+        HostOutput output;
+        void* outputContext;
+        LatencyHistogram latency;
+        atomic<uint64_t> aiMoves;
+        atomic<uint64_t> gamesFinished;
+
+        void send(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+            char line[256];
+            va_list arguments;
+            va_start(arguments, format);
+            vsnprintf(line, sizeof(line), format, arguments);
+            va_end(arguments);
+            output(outputContext, line);
+        }
+
+        // Dipanggil dengan lock dipegang
+        void pushJob(uint32_t id) {
+            Session& session = sessions[id];
+            session.status = SESSION_THINKING;
+            session.requested = chrono::steady_clock::now();
+            jobs[(jobHead + jobCount++) % jobs.size()] = id;
+            jobReady.notify_one();
+        }
+
+        void releaseSlot(uint32_t id) {
+            sessions[id].status = SESSION_FREE;
+            freeSlots.push_back(id);
+        }
+
+        // Pemenang setelah langkah ("macan", "uwong", "draw"), atau "" jika permainan berlanjut;
+        // dipanggil dengan lock dipegang
+        string finishIfOver(Session& session) {
+            string winner = session.state.findWinner();
+            if (winner.empty() && session.plies >= SELFPLAY_MAX_PLIES) winner = "draw";
+            if (!winner.empty()) {
+                session.status = SESSION_OVER;
+                gamesFinished++;
+            }
+            return winner;
+        }
+
+        void sendMove(const char* tag, uint32_t id, const Move& move) {
+            Position to = cellPosition(move.to);
+            if (move.from == NO_CELL) {
+                send("%s %u %d %d", tag, id, to.x, to.y);
+            } else {
+                Position from = cellPosition(move.from);
+                send("%s %u %d %d %d %d", tag, id, from.x, from.y, to.x, to.y);
+            }
+        }
+
+        void runWorker() {
+            unique_ptr<AIEngine> engine = createEngine(settings, 1, tablebase, book, network);
+            SearchLimits limits = SearchLimits{settings.depth, double(settings.moveTimeMs), uint64_t(settings.nodes)};
+            for (;;) {
+                uint32_t id;
+                {
+                    unique_lock<mutex> guard(lock);
+                    jobReady.wait(guard, [&]() { return stopping || jobCount > 0; });
+                    if (stopping) return;
+                    id = jobs[jobHead];
+                    jobHead = (jobHead + 1) % jobs.size();
+                    jobCount--;
+                }
+
+                // Hanya worker ini yang menyentuh sesi selama SESSION_THINKING
+                Session& session = sessions[id];
+                SearchResult result = engine->search(session.state, limits);
+
+                string winner;
+                bool closed = false;
+                double milliseconds;
+                {
+                    // requested ditulis ulang oleh pushJob begitu sesi kembali SESSION_WAITING
+                    lock_guard<mutex> guard(lock);
+                    milliseconds = elapsedMilliseconds(session.requested);
+                    if (session.closing) {
+                        releaseSlot(id);
+                        closed = true;
+                    } else if (result.bestMove == NO_MOVE) {
+                        session.status = SESSION_OVER;
+                        gamesFinished++;
+                        winner = sideName(session.humanSide);
+                    } else {
+                        session.state.makeMove(result.bestMove);
+                        session.state.clearUndoStack();
+                        session.plies++;
+                        winner = finishIfOver(session);
+                        if (winner.empty()) session.status = SESSION_WAITING;
+                    }
+                }
+                if (closed) continue;
+
+                latency.record(milliseconds);
+                aiMoves++;
+                if (!(result.bestMove == NO_MOVE)) sendMove("ai", id, result.bestMove);
+                if (!winner.empty()) send("over %u %s", id, winner.c_str());
+            }
+        }
+
+        void handleNew(const char* sideText) {
+            Side human;
+            if (strcmp(sideText, "macan") == 0) human = SIDE_MACAN;
+            else if (strcmp(sideText, "uwong") == 0) human = SIDE_UWONG;
+            else return send("error - side must be macan or uwong");
+
+            uint32_t id;
+            {
+                lock_guard<mutex> guard(lock);
+                if (freeSlots.empty()) return send("error - session limit reached");
+                id = freeSlots.back();
+                freeSlots.pop_back();
+                Session& session = sessions[id];
+                session.state = MacananGameState();
+                session.humanSide = human;
+                session.closing = false;
+                session.plies = 0;
+                session.status = SESSION_WAITING;
+                send("new %u", id);
+                if (session.state.getSideToMove() != human) pushJob(id);
+            }
+        }
+
+        void handleMove(uint32_t id, const int* values, int count) {
+            lock_guard<mutex> guard(lock);
+            if (id >= sessions.size() || sessions[id].status == SESSION_FREE) return send("error %u no such session", id);
+            Session& session = sessions[id];
+            if (session.status != SESSION_WAITING) return send("error %u not your turn", id);
+
+            for (int i = 0; i < count; i++) {
+                if (values[i] < 0 || values[i] >= (i % 2 == 0 ? BOARD_WIDTH : BOARD_HEIGHT)) return send("error %u bad square", id);
+            }
+            bool placing = count == 2;
+            int8_t from = placing ? NO_CELL : int8_t(cellIndex(values[0], values[1]));
+            int8_t to = int8_t(placing ? cellIndex(values[0], values[1]) : cellIndex(values[2], values[3]));
+
+            MoveList moves;
+            session.state.generateMoves(moves);
+            const Move* chosen = find_if(moves.begin(), moves.end(),
+                                         [&](const Move& move) { return move.from == from && move.to == to; });
+            if (chosen == moves.end()) return send("error %u illegal move", id);
+
+            session.state.makeMove(*chosen);
+            session.state.clearUndoStack();
+            session.plies++;
+            string winner = finishIfOver(session);
+            if (!winner.empty()) return send("over %u %s", id, winner.c_str());
+            pushJob(id);
+        }
+
+        void handleClose(uint32_t id) {
+            lock_guard<mutex> guard(lock);
+            if (id >= sessions.size() || sessions[id].status == SESSION_FREE) return send("error %u no such session", id);
+            if (sessions[id].status == SESSION_THINKING) sessions[id].closing = true;
+            else releaseSlot(id);
+        }
+
+    public:
+        SessionHost(size_t capacity, int workerCount, const EngineSettings& engineSettings,
+                    const EndgameTablebase* endgameTablebase, const OpeningBook* openingBook,
+                    const NnueNetwork* nnue, HostOutput hostOutput, void* context)
+            : sessions(capacity), jobs(capacity), jobHead(0), jobCount(0), stopping(false), settings(engineSettings),
+              tablebase(endgameTablebase), book(openingBook), network(nnue), output(hostOutput),
+              outputContext(context), aiMoves(0), gamesFinished(0) {
+            freeSlots.reserve(capacity);
+            for (size_t i = capacity; i-- > 0; ) {
+                sessions[i].status = SESSION_FREE;
+                freeSlots.push_back(uint32_t(i));
+            }
+            for (int i = 0; i < workerCount; i++) workers.emplace_back(&SessionHost::runWorker, this);
+        }
+
+        ~SessionHost() {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            jobReady.notify_all();
+            for (thread& worker : workers) worker.join();
+        }
+
+        // Proses satu baris perintah; false untuk "quit"
+        bool handleLine(const char* line) {
+            char command[16] = "";
+            unsigned id = 0;
+            int values[4];
+            if (sscanf(line, "%15s", command) != 1) return true;
+
+            if (strcmp(command, "new") == 0) {
+                char side[16] = "";
+                sscanf(line, "%*s %15s", side);
+                handleNew(side);
+            } else if (strcmp(command, "move") == 0) {
+                int count = sscanf(line, "%*s %u %d %d %d %d", &id, &values[0], &values[1], &values[2], &values[3]) - 1;
+                if (count == 2 || count == 4) handleMove(id, values, count);
+                else send("error %u usage: move ID X Y | move ID FX FY TX TY", id);
+            } else if (strcmp(command, "close") == 0 && sscanf(line, "%*s %u", &id) == 1) {
+                handleClose(id);
+            } else if (strcmp(command, "show") == 0 && sscanf(line, "%*s %u", &id) == 1) {
+                lock_guard<mutex> guard(lock);
+                if (id >= sessions.size() || sessions[id].status == SESSION_FREE) return send("error %u no such session", id), true;
+                send("position %u %s", id, sessions[id].state.toPositionString().c_str());
+            } else if (strcmp(command, "stats") == 0) {
+                size_t active;
+                {
+                    lock_guard<mutex> guard(lock);
+                    active = sessions.size() - freeSlots.size();
+                }
+                send("stats sessions %zu ai_moves %llu games_finished %llu p50_ms %.2f p99_ms %.2f",
+                     active, (unsigned long long)aiMoves.load(), (unsigned long long)gamesFinished.load(),
+                     latency.percentile(0.5), latency.percentile(0.99));
+            } else if (strcmp(command, "quit") == 0) {
+                return false;
+            } else {
+                send("error - unknown command %s", command);
+            }
+            return true;
+        }
+
+        const LatencyHistogram& getLatency() const {
+            return latency;
+        }
+
+        uint64_t getAIMoves() const {
+            return aiMoves.load();
+        }
+
+        uint64_t getGamesFinished() const {
+            return gamesFinished.load();
+        }
+    };
+
+    // Keluaran host ke stdout; baris dari worker yang berbeda tidak saling bercampur
+    void writeHostLine(void* context, const char* line) {
+        lock_guard<mutex> guard(*static_cast<mutex*>(context));
+        fputs(line, stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+    }
+
+    // Mode serve: host banyak permainan lewat stdin/stdout (pipe), satu perintah per baris
+    int runServer(int argc, char* argv[]) {
+        size_t capacity = size_t(max(1, optionValue(argc, argv, "--sessions", 4096)));
+        int workerCount = max(1, optionValue(argc, argv, "--workers", int(thread::hardware_concurrency())));
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 16));
+        EngineSettings settings = engineOptions(argc, argv, "", DEFAULT_SEARCH_DEPTH, hashMegabytes);
+        EndgameTablebase tablebase;
+        OpeningBook book;
+        NnueNetwork network;
+        if (!loadTablebaseOption(argc, argv, tablebase) || !loadBookOption(argc, argv, book) ||
+            !loadNetworkOption(argc, argv, "", network)) {
+            return 1;
+        }
+        cerr << "Serving up to " << capacity << " sessions (" << sizeof(Session) << " bytes each) on "
+             << workerCount << " workers, AI " << engineName(settings) << endl;
+
+        mutex outputLock;
+        SessionHost host(capacity, workerCount, settings, tablebase.isLoaded() ? &tablebase : nullptr,
+                         book.isLoaded() ? &book : nullptr, network.isLoaded() ? &network : nullptr,
+                         writeHostLine, &outputLock);
+        char line[256];
+        while (fgets(line, sizeof(line), stdin) != nullptr && host.handleLine(line)) {}
+        return 0;
+    }
+
+    enum HostEventKind { EVENT_NEW, EVENT_AI, EVENT_OVER };
+
+    // Balasan host yang sudah diurai untuk klien tiruan loadgen
+    struct HostEvent {
+        HostEventKind kind;
+        int id;
+        int values[4];   // koordinat langkah AI; values[2] < 0 untuk penempatan
+    };
+
+    struct LoadEvents {
+        mutex lock;
+        condition_variable ready;
+        vector<HostEvent> queue;
+    };
+
+    // Penerima keluaran host untuk loadgen: hanya "new", "ai", dan "over" yang diteruskan
+    void collectHostLine(void* context, const char* line) {
+        LoadEvents& events = *static_cast<LoadEvents*>(context);
+        HostEvent event = {EVENT_NEW, 0, {-1, -1, -1, -1}};
+        unsigned id = 0;
+        if (sscanf(line, "ai %u %d %d %d %d", &id, &event.values[0], &event.values[1], &event.values[2],
+                   &event.values[3]) >= 3) {
+            event.kind = EVENT_AI;
+        } else if (sscanf(line, "over %u", &id) == 1) {
+            event.kind = EVENT_OVER;
+        } else if (sscanf(line, "new %u", &id) != 1) {
+            return;
+        }
+        event.id = int(id);
+        lock_guard<mutex> guard(events.lock);
+        events.queue.push_back(event);
+        events.ready.notify_one();
+    }
+
+    // Mode loadgen: klien tiruan sebanyak --sessions bermain langkah acak melawan SessionHost
+    // di proses yang sama sampai --moves langkah AI, lalu laporkan throughput dan latensi
+    int runLoadGenerator(int argc, char* argv[]) {
+        int clients = max(1, optionValue(argc, argv, "--sessions", 1000));
+        int workerCount = max(1, optionValue(argc, argv, "--workers", int(thread::hardware_concurrency())));
+        uint64_t targetMoves = uint64_t(max(1, optionValue(argc, argv, "--moves", 20000)));
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 16));
+        EngineSettings settings = engineOptions(argc, argv, "", 2, hashMegabytes);
+        mt19937 rng(uint32_t(optionValue(argc, argv, "--seed", 1)));
+
+        LoadEvents events;
+        SessionHost host(size_t(clients), workerCount, settings, nullptr, nullptr, nullptr, collectHostLine, &events);
+        vector<MacananGameState> mirrors(clients);
+        char line[64];
+
+        cout << "Load: " << clients << " sessions on " << workerCount << " workers, AI " << engineName(settings)
+             << ", " << sizeof(Session) << " bytes per session" << endl;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < clients; i++) host.handleLine(i % 2 == 0 ? "new macan" : "new uwong");
+
+        vector<HostEvent> batch;
+        uint64_t humanMoves = 0;
+        while (host.getAIMoves() < targetMoves) {
+            {
+                unique_lock<mutex> guard(events.lock);
+                events.ready.wait(guard, [&]() { return !events.queue.empty(); });
+                batch.swap(events.queue);
+            }
+            for (const HostEvent& event : batch) {
+                int id = event.id;
+                MacananGameState& mirror = mirrors[id];
+                if (event.kind == EVENT_NEW) {
+                    mirror = MacananGameState();
+                    // Klien Macan (sesi genap) jalan duluan
+                    if (id % 2 != 0) continue;
+                } else if (event.kind == EVENT_OVER) {
+                    snprintf(line, sizeof(line), "close %d", id);
+                    host.handleLine(line);
+                    host.handleLine(id % 2 == 0 ? "new macan" : "new uwong");
+                    continue;
+                } else {
+                    const int* values = event.values;
+                    bool placing = values[2] < 0;
+                    int8_t from = placing ? NO_CELL : int8_t(cellIndex(values[0], values[1]));
+                    int8_t to = int8_t(placing ? cellIndex(values[0], values[1]) : cellIndex(values[2], values[3]));
+                    MoveList moves;
+                    mirror.generateMoves(moves);
+                    for (const Move& move : moves) {
+                        if (move.from == from && move.to == to) {
+                            mirror.makeMove(move);
+                            break;
+                        }
+                    }
+                    mirror.clearUndoStack();
+                }
+
+                MoveList moves;
+                mirror.generateMoves(moves);
+                if (moves.empty() || mirror.isUwongDefeated()) continue;   // "over" menyusul
+                Move move = moves[rng() % moves.size()];
+                mirror.makeMove(move);
+                mirror.clearUndoStack();
+                Position to = cellPosition(move.to);
+                if (move.from == NO_CELL) {
+                    snprintf(line, sizeof(line), "move %d %d %d", id, to.x, to.y);
+                } else {
+                    Position from = cellPosition(move.from);
+                    snprintf(line, sizeof(line), "move %d %d %d %d %d", id, from.x, from.y, to.x, to.y);
+                }
+                host.handleLine(line);
+                humanMoves++;
+            }
+            batch.clear();
+        }
+        double seconds = elapsedMilliseconds(start) / 1000.0;
+
+        const LatencyHistogram& latency = host.getLatency();
+        cout << "AI moves: " << host.getAIMoves() << ", human moves: " << humanMoves << ", games finished: "
+             << host.getGamesFinished() << endl;
+        cout << "Time: " << fixed << setprecision(2) << seconds << " s, " << setprecision(0)
+             << host.getAIMoves() / max(seconds, 1e-9) << " AI moves/s ("
+             << host.getAIMoves() / max(seconds, 1e-9) / workerCount << " per worker)" << endl;
+        cout << "AI response latency: p50 " << setprecision(2) << latency.percentile(0.5) << " ms, p90 "
+             << latency.percentile(0.9) << " ms, p99 " << latency.percentile(0.99) << " ms, max "
+             << latency.percentile(1.0) << " ms" << endl;
+        return 0;
+    }
+
+    // Batas panjang jalur df-pn; jalur sepanjang ini dianggap gagal untuk penyerang seperti pengulangan
+    const int PROOF_MAX_PLY = UNDO_STACK_SIZE - 1;
+
+    enum ProofOutcome {
+        PROOF_UNKNOWN,      // batas node/waktu tercapai
+        PROOF_PROVEN,       // penyerang pasti menang
+        PROOF_DISPROVEN     // penyerang tidak bisa memaksa kemenangan
+    };
+
+    // Solver depth-first proof-number (df-pn, Nagai) dalam bentuk negamax dengan ambang 1 + 1/4
+    // (Pawlewicz). Pertanyaannya: dapatkah attacker memaksa kemenangan dari posisi akar?
+    // Pengulangan posisi di jalur saat ini dihitung gagal untuk penyerang; hasil yang bergantung
+    // pada jalur tersebut tetap disimpan di tabel (masalah GHI diabaikan, seperti kebanyakan solver df-pn).
+    // Entrinya disimpan di TranspositionTable, berdampingan dengan entri alpha-beta tanpa saling
+    // terbaca; ukuran tabel adalah batas memori solver, dan entri kecil yang belum terbukti
+    // dibuang (garbage collection) saat tabel penuh.
+    class ProofSolver {
+    private:
+        TranspositionTable& table;
+        MacananGameState state;
+        Side attacker;
+        uint64_t nodes;
+        uint64_t nodeLimit;
+        chrono::steady_clock::time_point deadline;
+        bool timed;
+        bool stopped;
+        uint64_t displacedStores;
+        uint64_t displaceLimit;
+        int collections;
+        uint64_t collected;
+        uint64_t path[UNDO_STACK_SIZE];
+        int pathLength;
+
+        bool onPath(uint64_t key) const {
+            for (int i = 0; i < pathLength; i++) {
+                if (path[i] == key) return true;
             }
+            return false;
+        }
 
-            // Bonus untuk jumlah Uwong yang tersisa
-            score += uwongPositions.size() * 100;
+        // Nilai posisi di mana penyerang gagal karena pengulangan atau jalur terlalu panjang
+        void attackerFails(uint32_t& phi, uint32_t& delta) const {
+            bool attackerToMove = state.getSideToMove() == attacker;
+            phi = attackerToMove ? PROOF_INFINITY : 0;
+            delta = attackerToMove ? 0 : PROOF_INFINITY;
+        }
 
-            // Bonus untuk formasi berkelompok (saling melindungi)
-            for (const auto& uwong1 : uwongPositions) {
-                for (const auto& uwong2 : uwongPositions) {
-                    if (uwong1 == uwong2) continue;
-                    int distance = abs(uwong1.x - uwong2.x) + abs(uwong1.y - uwong2.y);
-                    if (distance == 1) score += 20; // Bonus untuk Uwong yang berdekatan
-                }
+        void lookup(uint64_t key, uint32_t& phi, uint32_t& delta, uint64_t& work) const {
+            ProofEntry entry;
+            if (table.probeProof(key, entry)) {
+                phi = entry.phi;
+                delta = entry.delta;
+                work = entry.work;
+            } else {
+                phi = 1;
+                delta = 1;
+                work = 0;
             }
+        }
 
-            // Penalti untuk Uwong yang terlalu dekat dengan Macan
-            for (const auto& uwong : uwongPositions) {
-                for (const auto& macan : macanPositions) {
-                    int distance = abs(uwong.x - macan.x) + abs(uwong.y - macan.y);
-                    if (distance == 1) score -= 30; // Penalti jika terlalu dekat dengan Macan
-                }
-            }
+        void store(uint64_t key, uint32_t phi, uint32_t delta, uint64_t work) {
+            if (table.storeProof(key, phi, delta, work) || ++displacedStores < displaceLimit) return;
+            collected += table.collectProofEntries();
+            collections++;
+            displacedStores = 0;
+        }
 
-            return score;
+        void checkLimits() {
+            if (nodeLimit > 0 && nodes >= nodeLimit) stopped = true;
+            if (timed && (nodes & 1023) == 0 && chrono::steady_clock::now() >= deadline) stopped = true;
         }
 
-        // Menghitung skor untuk Macan
-        int evaluateMacanPosition() const {
-            int score = 0;
-            Position macanPos(-1, -1);
-            vector<Position> uwongPositions;
+        // Posisi akhir dari sisi pemain jalan; false jika permainan berlanjut
+        bool terminal(const MoveList& moves, uint32_t& phi, uint32_t& delta) const {
+            bool won;
+            if (state.isUwongDefeated()) won = state.getSideToMove() == SIDE_MACAN;
+            else if (moves.empty()) won = false;
+            else return false;
+            phi = won ? 0 : PROOF_INFINITY;
+            delta = won ? PROOF_INFINITY : 0;
+            return true;
+        }
 
-            // Kumpulkan posisi semua piece
-            for (const auto& piece : pieces) {
-                if (piece.pieceType == "macan") {
-                    macanPos = piece.position;
-                } else {
-                    uwongPositions.push_back(piece.position);
-                }
+        // Multiple iterative deepening pada posisi state sampai phi >= thPhi atau delta >= thDelta
+        void search(uint32_t thPhi, uint32_t thDelta) {
+            uint64_t key = state.getCanonicalKey();
+            uint64_t startNodes = nodes++;
+            checkLimits();
+
+            uint32_t phi, delta;
+            uint64_t work;
+            MoveList moves;
+            state.generateMoves(moves);
+            if (terminal(moves, phi, delta)) {
+                store(key, phi, delta, 1);
+                return;
             }
+            lookup(key, phi, delta, work);
 
-            // Bonus tinggi jika bisa memakan Uwong
-            if (canEatUwong(macanPos)) {
-                score += 1000;
+            // Kunci kanonik anak dihitung sekali; anak yang mengulang jalur punya nilai tetap
+            uint64_t childKeys[MAX_MOVES];
+            bool repeated[MAX_MOVES];
+            path[pathLength++] = state.getHashKey();
+            for (int i = 0; i < moves.size(); i++) {
+                state.makeMove(moves[i]);
+                childKeys[i] = state.getCanonicalKey();
+                repeated[i] = onPath(state.getHashKey()) || pathLength >= PROOF_MAX_PLY;
+                state.unmakeMove();
             }
 
-            // Bonus untuk posisi strategis di tengah
-            score += calculatePositionScore(macanPos) * 5;
+            while (!stopped) {
+                // phi = min delta anak, delta = jumlah phi anak; anak terbaik punya delta terkecil
+                int best = 0;
+                uint32_t bestPhi = 0, secondDelta = PROOF_INFINITY, deltaSum = 0;
+                phi = PROOF_INFINITY;
+                for (int i = 0; i < moves.size(); i++) {
+                    uint32_t childPhi, childDelta;
+                    uint64_t childWork;
+                    if (repeated[i]) {
+                        state.makeMove(moves[i]);
+                        attackerFails(childPhi, childDelta);
+                        state.unmakeMove();
+                    } else {
+                        lookup(childKeys[i], childPhi, childDelta, childWork);
+                    }
+                    deltaSum = min(PROOF_INFINITY, deltaSum + childPhi);
+                    if (childDelta < phi) {
+                        secondDelta = phi;
+                        phi = childDelta;
+                        bestPhi = childPhi;
+                        best = i;
+                    } else if (childDelta < secondDelta) {
+                        secondDelta = childDelta;
+                    }
+                }
+                delta = deltaSum;
+                if (phi >= thPhi || delta >= thDelta) break;
 
-            // Hitung jarak ke Uwong terdekat
-            int minDistanceToUwong = 999;
-            for (const auto& uwongPos : uwongPositions) {
-                int distance = abs(macanPos.x - uwongPos.x) + abs(macanPos.y - uwongPos.y);
-                minDistanceToUwong = min(minDistanceToUwong, distance);
+                uint32_t childThPhi = thDelta >= PROOF_INFINITY ? PROOF_INFINITY
+                                    : min<uint64_t>(PROOF_INFINITY, uint64_t(thDelta) - delta + bestPhi);
+                uint32_t childThDelta = min<uint64_t>(thPhi, uint64_t(secondDelta) + 1 + secondDelta / 4);
+                state.makeMove(moves[best]);
+                search(childThPhi, childThDelta);
+                state.unmakeMove();
             }
+            pathLength--;
+            store(key, phi, delta, work + (nodes - startNodes));
+        }
 
-            // Penalti jika terlalu dekat dengan banyak Uwong
-            if (minDistanceToUwong == 1) {
-                score -= 50;
+        // Nilai anak untuk menyusun jalur menang; false jika entrinya sudah hilang dari tabel
+        // atau anak mengulang posisi di jalur
+        bool childValue(const Move& move, uint32_t& phi, uint32_t& delta, uint64_t& work) {
+            state.makeMove(move);
+            if (onPath(state.getHashKey())) {
+                state.unmakeMove();
+                return false;
             }
-
-            return score;
+            MoveList moves;
+            state.generateMoves(moves);
+            bool found = terminal(moves, phi, delta);
+            work = 0;
+            if (!found) {
+                ProofEntry entry;
+                found = table.probeProof(state.getCanonicalKey(), entry);
+                phi = entry.phi;
+                delta = entry.delta;
+                work = entry.work;
+            }
+            state.unmakeMove();
+            return found;
         }
 
     public:
-        MacananGameState()
-            : currentTurn("macan"),
-            remainingUwong(8),
-            remainingMacan(2),
-            macanPhase("PLACING"),
-            uwongPhase("PLACING"),
-            winner(""),
-            humanPlayer(""),
-            aiPlayer("")
-        {}
+        explicit ProofSolver(TranspositionTable& table)
+            : table(table), attacker(SIDE_MACAN), nodes(0), nodeLimit(0), timed(false), stopped(false),
+              displacedStores(0), displaceLimit(0), collections(0), collected(0), pathLength(0) {}
 
-        void setPlayers(const string& human) {
-            humanPlayer = human;
-            aiPlayer = (human == "macan") ? "uwong" : "macan";
-        }
+        // Batas 0 berarti tanpa batas
+        ProofOutcome solve(const MacananGameState& root, Side attackingSide, uint64_t maxNodes, double timeMs) {
+            state = root;
+            state.clearUndoStack();
+            attacker = attackingSide;
+            nodes = 0;
+            nodeLimit = maxNodes;
+            timed = timeMs > 0;
+            deadline = chrono::steady_clock::now() + chrono::microseconds(int64_t(timeMs * 1000));
+            stopped = false;
+            displacedStores = 0;
+            displaceLimit = max<uint64_t>(1024, table.sizeInBytes() / 16 / 64);
+            collections = 0;
+            collected = 0;
+            pathLength = 0;
+            table.newSearch();
 
-        bool isAITurn() const {
-            return currentTurn == aiPlayer;
-        }
+            uint32_t phi = 1, delta = 1;
+            uint64_t work;
+            while (!stopped && phi != 0 && delta != 0) {
+                uint32_t previousPhi = phi, previousDelta = delta;
+                uint64_t previousNodes = nodes;
+                search(PROOF_INFINITY, PROOF_INFINITY);
+                MoveList moves;
+                state.generateMoves(moves);
+                if (!terminal(moves, phi, delta)) lookup(state.getCanonicalKey(), phi, delta, work);
 
-        // Evaluasi board untuk AI
-        int evaluateBoard() const {
-            if (aiPlayer == "macan") {
-                return evaluateMacanPosition() - evaluateUwongPosition();
-            } else {
-                return evaluateUwongPosition() - evaluateMacanPosition();
+                // Angka akar jenuh tanpa bukti/sanggahan: iterasi berikutnya tidak akan berbeda
+                if (phi == previousPhi && delta == previousDelta && nodes - previousNodes <= 1) break;
             }
+            if (phi == 0 || delta == 0) {
+                bool attackerWins = (phi == 0) == (state.getSideToMove() == attacker);
+                return attackerWins ? PROOF_PROVEN : PROOF_DISPROVEN;
+            }
+            return PROOF_UNKNOWN;
         }
 
-        // AI membuat gerakan
-        void makeAIMove() {
-            if (getGamePhase() == "PLACING") {
-                makeAIPlacement();
-                
-            } else {
-                makeAIMovement();
+        // Jalur utama bukti setelah PROOF_PROVEN: penyerang memilih anak terbukti kalah dengan subpohon
+        // terkecil (kemenangan tercepat), pembela memilih subpohon terbesar (perlawanan terpanjang);
+        // posisi yang sudah ada di jalur dilewati. Berhenti di akhir permainan (complete), atau lebih
+        // awal jika entri sudah dibuang dari tabel.
+        vector<Move> winningLine(const MacananGameState& root, bool& complete) {
+            state = root;
+            state.clearUndoStack();
+            vector<Move> line;
+            complete = false;
+            pathLength = 0;
+            while (int(line.size()) < PROOF_MAX_PLY) {
+                MoveList moves;
+                uint32_t phi, delta;
+                state.generateMoves(moves);
+                if (terminal(moves, phi, delta)) {
+                    complete = true;
+                    break;
+                }
+
+                bool attackerToMove = state.getSideToMove() == attacker;
+                int chosen = -1;
+                uint64_t chosenWork = 0;
+                path[pathLength++] = state.getHashKey();
+                for (int i = 0; i < moves.size(); i++) {
+                    uint32_t childPhi, childDelta;
+                    uint64_t childWork;
+                    if (!childValue(moves[i], childPhi, childDelta, childWork)) continue;
+                    if ((attackerToMove ? childDelta : childPhi) != 0) continue;
+                    if (chosen < 0 || (attackerToMove ? childWork < chosenWork : childWork > chosenWork)) {
+                        chosen = i;
+                        chosenWork = childWork;
+                    }
+                }
+                if (chosen < 0) break;
+                line.push_back(moves[chosen]);
+                state.makeMove(moves[chosen]);
             }
+            return line;
         }
 
-        string getGamePhase() const {
-            return currentTurn == "macan" ? macanPhase : uwongPhase;
+        uint64_t getNodes() const { return nodes; }
+        int getCollections() const { return collections; }
+        uint64_t getCollected() const { return collected; }
+    };
+
+    // Mode solve: buktikan kemenangan paksa dengan df-pn dari --position (default posisi awal).
+    // --side macan|uwong memilih penyerang (default pemain jalan); --hash MB membatasi memori;
+    // --nodes dan --time MS membatasi pencarian.
+    int runSolver(int argc, char* argv[]) {
+        MacananGameState root;
+        string position = optionString(argc, argv, "--position", "");
+        if (!position.empty() && !root.setPosition(position)) {
+            cout << "Invalid position: " << position << endl;
+            return 1;
+        }
+        string sideText = optionString(argc, argv, "--side", sideName(root.getSideToMove()));
+        if (sideText != "macan" && sideText != "uwong") {
+            cout << "Usage: macanan solve [--position \"POSITION\"] [--side macan|uwong] [--hash MB] "
+                 << "[--nodes N] [--time MS]" << endl;
+            return 1;
         }
+        Side attacker = sideText == "macan" ? SIDE_MACAN : SIDE_UWONG;
+        int hashMegabytes = max(1, optionValue(argc, argv, "--hash", 64));
+        uint64_t maxNodes = uint64_t(max(0, optionValue(argc, argv, "--nodes", 0)));
+        double timeMs = max(0, optionValue(argc, argv, "--time", 0));
 
-        bool canMove(const string& playerType) const {
-            if (playerType == "macan") {
-                return macanPhase == "MOVING";
-            } else {  // uwong
-                return uwongPhase == "MOVING";
-            }
+        TranspositionTable table{size_t(hashMegabytes)};
+        ProofSolver solver(table);
+        cout << "Position: " << root.toPositionString() << endl;
+        cout << "Question: can " << sideText << " force a win? (" << table.sizeInBytes() / (1 << 20)
+             << " MB table)" << endl;
+
+        auto start = chrono::steady_clock::now();
+        ProofOutcome outcome = solver.solve(root, attacker, maxNodes, timeMs);
+        double milliseconds = elapsedMilliseconds(start);
+
+        if (outcome == PROOF_PROVEN) {
+            bool complete;
+            vector<Move> line = solver.winningLine(root, complete);
+            cout << "Proven: " << sideText << " wins" << endl;
+            cout << "Line (" << line.size() << " plies" << (complete ? "" : ", truncated") << "):";
+            for (const Move& move : line) cout << " " << moveToString(move);
+            cout << endl;
+        } else if (outcome == PROOF_DISPROVEN) {
+            cout << "Disproven: " << sideText << " cannot force a win" << endl;
+        } else {
+            cout << "Unknown: limit reached" << endl;
         }
+        cout << "Nodes: " << solver.getNodes() << ", " << fixed << setprecision(1) << milliseconds << " ms, "
+             << setprecision(0) << solver.getNodes() / max(milliseconds / 1000.0, 1e-9) << " nps" << endl;
+        cout << "Table: " << table.countProofEntries() << " proof entries, " << solver.getCollections()
+             << " collections removed " << solver.getCollected() << " entries" << endl;
+        return 0;
+    }
 
-        bool addPiece(const string& pieceType, int x, int y) {
-            // Cek apakah pemain sudah dalam fase MOVING
-            if ((pieceType == "macan" && macanPhase == "MOVING") ||
-                (pieceType == "uwong" && uwongPhase == "MOVING")) {
-                cout << "Cannot place pieces after completing placement phase!" << endl;
-                return false;
-            }
+    // Mode evalbench: cek evaluasi batch terhadap evaluasi inkremental, lalu ukur throughput
+    // jalur skalar dan jalur yang dipilih untuk CPU ini pada posisi dari permainan acak
+    int runEvalBenchmark(int argc, char* argv[]) {
+        int count = max(1, optionValue(argc, argv, "--positions", 1 << 16));
+        int rounds = max(1, optionValue(argc, argv, "--rounds", 200));
 
-            bool valid = false;
-            if (!isPlayablePosition(x, y)) {
-                cout << "Invalid position! (" << x << ", " << y << ") is not playable." << endl;
-                return valid;
+        vector<PackedPosition> positions;
+        vector<int> expected;
+        mt19937 rng(20240601);
+        while (int(positions.size()) < count) {
+            MacananGameState state;
+            for (int ply = 0; ply < 200 && int(positions.size()) < count && !state.isUwongDefeated(); ply++) {
+                MoveList moves;
+                state.generateMoves(moves);
+                if (moves.empty()) break;
+                state.makeMove(moves[rng() % moves.size()]);
+                state.clearUndoStack();
+                positions.push_back(state.pack());
+                expected.push_back(state.evaluateForSideToMove());
             }
+        }
 
-            Position newPos(x, y);
-            if (isPositionOccupied(newPos)) {
-                cout << "Position already occupied at (" << x << ", " << y << ")." << endl;
-                return valid;
-            }
+        vector<int> scores(positions.size());
+        auto measure = [&](BatchEvaluator evaluator, const char* name) {
+            evaluator(positions.data(), scores.data(), positions.size());
+            size_t mismatches = 0;
+            for (size_t i = 0; i < positions.size(); i++) mismatches += scores[i] != expected[i];
 
-            if (pieceType == "uwong" && remainingUwong > 0) {
-                remainingUwong--;
-                pieces.emplace_back(pieceType, newPos);
-                valid = true;
-                
-                // Check if Uwong placement is complete
-                if (remainingUwong == 0) {
-                    uwongPhase = "MOVING";
-                    cout << "Uwong placement complete. Uwong can now move!" << endl;
-                }
-            } else if (pieceType == "macan" && remainingMacan > 0) {
-                remainingMacan--;
-                pieces.emplace_back(pieceType, newPos);
-                valid = true;
-                
-                // Check if Macan placement is complete
-                if (remainingMacan == 0) {
-                    macanPhase = "MOVING";
-                    cout << "Macan placement complete. Macan can now move!" << endl;
-                }
+            auto start = chrono::steady_clock::now();
+            int64_t checksum = 0;
+            for (int round = 0; round < rounds; round++) {
+                evaluator(positions.data(), scores.data(), positions.size());
+                checksum += scores[round % scores.size()];
             }
+            double milliseconds = elapsedMilliseconds(start);
+            double rate = double(positions.size()) * rounds / max(milliseconds, 1e-3) / 1000.0;
+            cout << setw(8) << name << setw(12) << fixed << setprecision(1) << milliseconds
+                 << setw(12) << setprecision(1) << rate << setw(12) << mismatches
+                 << "  (checksum " << checksum << ")" << endl;
+            return rate;
+        };
 
-            return valid;
+        cout << "Batch evaluation: " << positions.size() << " positions x " << rounds
+             << " rounds, dispatch " << batchEvaluatorName() << endl;
+        cout << setw(8) << "path" << setw(12) << "time_ms" << setw(12) << "Mpos/s" << setw(12) << "mismatches" << endl;
+        double scalarRate = measure(evaluateBatchScalar, "scalar");
+        if (BATCH_EVALUATOR != evaluateBatchScalar) {
+            double rate = measure(BATCH_EVALUATOR, batchEvaluatorName());
+            cout << "Speedup: " << setprecision(2) << rate / scalarRate << "x" << endl;
         }
+        return 0;
+    }
 
-        bool isPlayablePosition(int x, int y) const {
-            if (x < 0 || x >= BOARD_WIDTH || y < 0 || y >= BOARD_HEIGHT) {
+    // Dataset yang dibaca lewat memory map untuk tuning; setiap pass memindai semua rekaman berurutan
+    class DatasetReader {
+    private:
+        vector<unique_ptr<MappedFile>> files;
+        vector<pair<const DatasetRecord*, size_t>> spans;
+        uint64_t total;
+
+    public:
+        DatasetReader() : total(0) {}
+
+        bool add(const string& path) {
+            unique_ptr<MappedFile> file(new MappedFile());
+            if (!file->open(path) || file->size() < sizeof(DatasetHeader)) return false;
+            DatasetHeader header;
+            memcpy(&header, file->data(), sizeof(header));
+            if (memcmp(header.magic, "MCDS", 4) != 0 || header.version != DATASET_VERSION ||
+                header.recordSize != sizeof(DatasetRecord)) {
                 return false;
             }
-            return playable[y][x];
+            size_t count = (file->size() - sizeof(header)) / sizeof(DatasetRecord);
+            spans.emplace_back(reinterpret_cast<const DatasetRecord*>(file->data() + sizeof(header)), count);
+            total += count;
+            files.push_back(move(file));
+            return true;
         }
 
-        bool isPositionOccupied(const Position& pos) const {
-            for (const auto& piece : pieces) {
-                if (piece.position == pos) {
-                    return true;
-                }
-            }
-            return false;
+        uint64_t size() const {
+            return total;
         }
 
-        void printBoard() const {
-            char board[BOARD_HEIGHT][BOARD_WIDTH] = {
-                {' ', ' ', '.', '.', '.', '.', '.', ' ', ' '},
-                {'.', ' ', '.', '.', '.', '.', '.', ' ', '.'},
-                {' ', '.', ' ', ' ', ' ', ' ', ' ', '.', ' '},
-                {'.', '.', '.', '.', '.', '.', '.', '.', '.'},
-                {' ', '.', ' ', ' ', ' ', ' ', ' ', '.', ' '},
-                {'.', ' ', '.', '.', '.', '.', '.', ' ', '.'},
-                {' ', ' ', '.', '.', '.', '.', '.', ' ', ' '}
-            };
-
-            for (const auto& piece : pieces) {
-                if (piece.pieceType == "macan") {
-                    board[piece.position.y][piece.position.x] = 'M';
-                } else if (piece.pieceType == "uwong") {
-                    board[piece.position.y][piece.position.x] = 'U';
-                }
-            }
-            for (int y = 0; y < BOARD_HEIGHT; y++) {
-                for (int x = 0; x < BOARD_WIDTH; x++) {
-                    if(board[y][x]=='.'){
-                        cout<<"("<<x<<","<<y<<")";
-                    }else if(board[y][x]==' '){
-                        cout<<"     ";
-                    }else{
-                        cout <<board[y][x] <<"("<<x<<","<<y<<")";
+        // Panggil visit(part, begin, end) untuk potongan rekaman berurutan; setiap berkas
+        // dibagi rata ke threads bagian
+        template <typename Visitor>
+        void scan(int threads, Visitor visit) const {
+            vector<thread> workers;
+            for (int part = 0; part < threads; part++) {
+                workers.emplace_back([&, part]() {
+                    for (const auto& span : spans) {
+                        size_t begin = span.second * part / threads;
+                        size_t end = span.second * (part + 1) / threads;
+                        visit(part, span.first + begin, span.first + end);
                     }
-                }
-                cout << endl;
+                });
             }
+            for (thread& worker : workers) worker.join();
         }
+    };
 
-        void switchTurn() {
-            currentTurn = (currentTurn == "macan") ? "uwong" : "macan";
-        }
+    // Tuning Texel: peluang Macan menang diperkirakan sigmoid(K * evaluasi / 400) dengan basis 10
+    struct TexelPass {
+        double loss;
+        double gradient[EVAL_TERM_COUNT];
+    };
 
-        string getCurrentTurn() const {
-            return currentTurn;
+    // Tambahkan error dan gradien rekaman [begin, end) ke pass; scale = K * ln(10) / 400
+    inline __attribute__((always_inline)) void texelAccumulate(const DatasetRecord* begin, const DatasetRecord* end,
+                                                               const double* weights, double scale, TexelPass& pass) {
+        for (const DatasetRecord* record = begin; record != end; record++) {
+            int features[EVAL_TERM_COUNT];
+            evalFeatures(datasetMacans(*record), datasetUwongs(*record), features);
+            double score = 0;
+            for (int t = 0; t < EVAL_TERM_COUNT; t++) score += EVAL_TERM_SIGN[t] * weights[t] * features[t];
+            double probability = 1.0 / (1.0 + exp(-scale * score));
+            double error = datasetResult(*record) - probability;
+            pass.loss += error * error;
+            double slope = -2.0 * error * probability * (1.0 - probability) * scale;
+            for (int t = 0; t < EVAL_TERM_COUNT; t++) pass.gradient[t] += slope * EVAL_TERM_SIGN[t] * features[t];
         }
-        
-        
+    }
 
-        int evaluatePosition() {
-            int score = 0;
-            Position macanPos(-1, -1);
-            vector<Position> uwongPositions;
+    typedef void (*TexelScanFunction)(const DatasetRecord* begin, const DatasetRecord* end,
+                                      const double* weights, double scale, TexelPass& pass);
 
-            // Mengumpulkan posisi semua piece
-            for (const auto& piece : pieces) {
-                if (piece.pieceType == "macan") {
-                    macanPos = piece.position;
-                } else if (piece.pieceType == "uwong") {
-                    uwongPositions.push_back(piece.position);
-                }
-            }
+    void texelScanScalar(const DatasetRecord* begin, const DatasetRecord* end, const double* weights, double scale,
+                         TexelPass& pass) {
+        texelAccumulate(begin, end, weights, scale, pass);
+    }
 
-            // Jika bisa memakan Uwong, berikan skor tinggi
-            if (canEatUwong(macanPos)) {
-                score += 1000;
-            }
+    #ifdef MACANAN_X86
+    // Build default tidak memakai instruksi popcnt; pass tuning didominasi popcount
+    __attribute__((target("popcnt"))) void texelScanPopcnt(const DatasetRecord* begin, const DatasetRecord* end,
+                                                           const double* weights, double scale, TexelPass& pass) {
+        texelAccumulate(begin, end, weights, scale, pass);
+    }
+    #endif
 
-            // Nilai posisi strategis (dekat tengah)
-            score += calculatePositionScore(macanPos) * 5;
+    inline TexelScanFunction selectTexelScan() {
+    #ifdef MACANAN_X86
+        if (__builtin_cpu_supports("popcnt")) return texelScanPopcnt;
+    #endif
+        return texelScanScalar;
+    }
 
-            // Hitung jarak aman dari Uwong
-            int minDistanceToUwong = 999;
-            for (const auto& uwongPos : uwongPositions) {
-                int distance = abs(macanPos.x - uwongPos.x) + abs(macanPos.y - uwongPos.y);
-                minDistanceToUwong = min(minDistanceToUwong, distance);
-            }
+    const TexelScanFunction TEXEL_SCAN = selectTexelScan();
 
-            // Jika terlalu dekat dengan banyak Uwong, kurangi skor
-            if (minDistanceToUwong == 1) {
-                score -= 50;
-            }
+    TexelPass texelPass(const DatasetReader& data, const double* weights, double k, int threads) {
+        vector<TexelPass> parts(threads, TexelPass());
+        double scale = k * log(10.0) / 400.0;
+        data.scan(threads, [&](int part, const DatasetRecord* begin, const DatasetRecord* end) {
+            TEXEL_SCAN(begin, end, weights, scale, parts[part]);
+        });
 
-            return score;
+        TexelPass total = TexelPass();
+        double count = double(max<uint64_t>(data.size(), 1));
+        for (const TexelPass& pass : parts) {
+            total.loss += pass.loss / count;
+            for (int t = 0; t < EVAL_TERM_COUNT; t++) total.gradient[t] += pass.gradient[t] / count;
         }
+        return total;
+    }
 
-        bool movePiece(const Position& from, const Position& to) {
-            // Cek apakah pemain sudah bisa bergerak
-            string currentPieceType = "";
-            for (const auto& piece : pieces) {
-                if (piece.position == from) {
-                    currentPieceType = piece.pieceType;
-                    break;
-                }
-            }
+    // Mode tune: sesuaikan bobot evaluasi ke hasil permainan di berkas dataset (dari selfplay --dataset)
+    int runTuner(int argc, char* argv[]) {
+        int threads = max(1, optionValue(argc, argv, "--threads", int(thread::hardware_concurrency())));
+        int iterations = max(1, optionValue(argc, argv, "--iterations", 500));
+        double rate = max(1, optionValue(argc, argv, "--rate", 8));
 
-            if (currentPieceType == "macan" && macanPhase != "MOVING") {
-                cout << "Macan must complete placement phase first!" << endl;
-                return false;
-            } else if (currentPieceType == "uwong" && uwongPhase != "MOVING") {
-                cout << "Uwong must complete placement phase first!" << endl;
-                return false;
+        DatasetReader data;
+        for (int i = 2; i < argc && argv[i][0] != '-'; i++) {
+            if (!data.add(argv[i])) {
+                cerr << "Cannot read dataset " << argv[i] << endl;
+                return 1;
             }
+        }
+        if (data.size() == 0) {
+            cout << "Usage: macanan tune DATASET... [--iterations N] [--rate R] [--threads N]" << endl;
+            return 1;
+        }
 
-            // Cek apakah ada pion di posisi awal
-            int pieceIndex = -1;
-            for (size_t i = 0; i < pieces.size(); i++) {
-                if (pieces[i].position == from) {
-                    pieceIndex = i;
-                    break;
-                }
+        double weights[EVAL_TERM_COUNT];
+        for (int t = 0; t < EVAL_TERM_COUNT; t++) weights[t] = EVAL_WEIGHTS[t];
+        auto start = chrono::steady_clock::now();
+
+        // K dipilih dulu untuk bobot saat ini (golden-section pada log10 K), lalu tetap selama tuning
+        double low = -6.0, high = 1.0;
+        const double ratio = (sqrt(5.0) - 1) / 2;
+        for (int step = 0; step < 30; step++) {
+            double a = high - ratio * (high - low), b = low + ratio * (high - low);
+            if (texelPass(data, weights, pow(10.0, a), threads).loss < texelPass(data, weights, pow(10.0, b), threads).loss) high = b;
+            else low = a;
+        }
+        double k = pow(10.0, (low + high) / 2);
+        double initialLoss = texelPass(data, weights, k, threads).loss;
+        cout << "Dataset: " << data.size() << " positions, K " << fixed << setprecision(4) << k
+             << ", loss " << setprecision(6) << initialLoss << endl;
+
+        // Adam pada bobot (satuan evaluasi), satu pass penuh per iterasi
+        double moment[EVAL_TERM_COUNT] = {}, velocity[EVAL_TERM_COUNT] = {};
+        double loss = initialLoss;
+        for (int iteration = 1; iteration <= iterations; iteration++) {
+            TexelPass pass = texelPass(data, weights, k, threads);
+            loss = pass.loss;
+            for (int t = 0; t < EVAL_TERM_COUNT; t++) {
+                moment[t] = 0.9 * moment[t] + 0.1 * pass.gradient[t];
+                velocity[t] = 0.999 * velocity[t] + 0.001 * pass.gradient[t] * pass.gradient[t];
+                double corrected = moment[t] / (1 - pow(0.9, iteration));
+                double scale = sqrt(velocity[t] / (1 - pow(0.999, iteration))) + 1e-12;
+                weights[t] -= rate * corrected / scale;
             }
-            
-            if (pieceIndex == -1) {
-                cout << "No piece at starting position!" << endl;
-                return false;
+            if (iteration % 20 == 0 || iteration == iterations) {
+                cout << "Iteration " << iteration << ": loss " << setprecision(6) << loss << ", "
+                     << setprecision(1) << elapsedMilliseconds(start) / 1000.0 << " s" << endl;
             }
+        }
 
-            // Cek apakah gerakan valid
-            vector<Position> validMoves = getValidMoves(from);
-            bool isValidMove = false;
-            for (const auto& move : validMoves) {
-                if (move == to) {
-                    isValidMove = true;
-                    break;
-                }
-            }
+        cout << "Loss " << setprecision(6) << initialLoss << " -> " << loss << ". Tuned weights:" << endl;
+        for (int t = 0; t < EVAL_TERM_COUNT; t++) {
+            cout << "    const int " << EVAL_TERM_NAMES[t] << " = " << lround(weights[t])
+                 << ";    // was " << EVAL_WEIGHTS[t] << endl;
+        }
+        return 0;
+    }
 
-            // Cek apakah ini gerakan memakan untuk Macan
-            if (!isValidMove && pieces[pieceIndex].pieceType == "macan") {
-                // Cek gerakan makan (2 langkah)
-                int dx = to.x - from.x;
-                int dy = to.y - from.y;
-                
-                // Harus bergerak 2 langkah
-                if (abs(dx) == 2 || abs(dy) == 2) {
-                    Position middle(from.x + dx/2, from.y + dy/2);
-                    
-                    // Cek apakah ada Uwong di tengah
-                    bool uwongInMiddle = false;
-                    int uwongIndex = -1;
-                    for (size_t i = 0; i < pieces.size(); i++) {
-                        if (pieces[i].position == middle && pieces[i].pieceType == "uwong") {
-                            uwongInMiddle = true;
-                            uwongIndex = i;
-                            break;
-                        }
-                    }
+    // Satu contoh latih NNUE: posisi dan skor targetnya untuk pemain jalan
+    struct NnueSample {
+        PackedPosition position;
+        float target;
+    };
 
-                    if (uwongInMiddle && !isPositionOccupied(to) && isPlayablePosition(to.x, to.y)) {
-                        // Hapus Uwong yang dimakan
-                        pieces.erase(pieces.begin() + uwongIndex);
-                        isValidMove = true;
-                    }
-                }
+    // Bobot NNUE dalam float selama pelatihan, sebelum dikuantisasi
+    struct NnueTrainingNetwork {
+        vector<float> featureWeights;   // [NNUE_INPUTS][NNUE_HIDDEN]
+        vector<float> featureBias;
+        vector<float> outputWeights;    // [2][NNUE_HIDDEN]
+        float outputBias[2];
+
+        // Fitur aktif satu posisi; mengembalikan jumlahnya
+        static int activeFeatures(const PackedPosition& position, int* features) {
+            int count = 0;
+            for (Bitboard macans = position.macans & ~PACKED_UWONG_TO_MOVE; macans; ) {
+                features[count++] = nnueFeature(SIDE_MACAN, popLowestCell(macans));
+            }
+            for (Bitboard uwongs = position.uwongs; uwongs; ) {
+                features[count++] = nnueFeature(SIDE_UWONG, popLowestCell(uwongs));
             }
+            return count;
+        }
 
-            if (!isValidMove) {
-                cout << "Invalid move!" << endl;
-                return false;
+        // Satu langkah SGD pada sample (target dalam unit keluaran jaringan); mengembalikan error sebelum update
+        float train(const NnueSample& sample, float target, float rate) {
+            int features[MACAN_COUNT + UWONG_COUNT];
+            int count = activeFeatures(sample.position, features);
+            int side = (sample.position.macans & PACKED_UWONG_TO_MOVE) ? SIDE_UWONG : SIDE_MACAN;
+
+            float hidden[NNUE_HIDDEN];
+            float output = outputBias[side];
+            float* weights = &outputWeights[side * NNUE_HIDDEN];
+            for (int j = 0; j < NNUE_HIDDEN; j++) {
+                float sum = featureBias[j];
+                for (int k = 0; k < count; k++) sum += featureWeights[features[k] * NNUE_HIDDEN + j];
+                hidden[j] = sum;
+                output += weights[j] * min(max(sum, 0.0f), 1.0f);
             }
 
-            // Lakukan gerakan
-            pieces[pieceIndex].position = to;
-            return true;
+            float error = output - target;
+            float step = rate * error;
+            float weightLimit = float(NNUE_CLIP) / NNUE_WEIGHT_SCALE;   // agar muat di int8
+            outputBias[side] -= step;
+            for (int j = 0; j < NNUE_HIDDEN; j++) {
+                float pre = hidden[j];
+                if (pre > 0.0f && pre < 1.0f) {
+                    float gradient = step * weights[j];
+                    featureBias[j] -= gradient;
+                    for (int k = 0; k < count; k++) featureWeights[features[k] * NNUE_HIDDEN + j] -= gradient;
+                }
+                weights[j] = max(-weightLimit, min(weightLimit, weights[j] - step * min(max(pre, 0.0f), 1.0f)));
+            }
+            return error;
         }
 
-        // Helper function untuk menampilkan gerakan yang mungkin
-        void showPossibleMoves(const Position& pos) const {
-            vector<Position> moves = getValidMoves(pos);
-            cout << "Possible moves from (" << pos.x << "," << pos.y << "):" << endl;
-            for (const auto& move : moves) {
-                cout << "-> (" << move.x << "," << move.y << ")" << endl;
+        void quantize(NnueWeights& out) const {
+            auto round16 = [](float value) { return int16_t(max(-32767.0f, min(32767.0f, roundf(value * NNUE_CLIP)))); };
+            for (int f = 0; f < NNUE_INPUTS; f++) {
+                for (int j = 0; j < NNUE_HIDDEN; j++) out.featureWeights[f][j] = round16(featureWeights[f * NNUE_HIDDEN + j]);
+            }
+            for (int j = 0; j < NNUE_HIDDEN; j++) out.featureBias[j] = round16(featureBias[j]);
+            for (int side = 0; side < 2; side++) {
+                for (int j = 0; j < NNUE_HIDDEN; j++) {
+                    float value = roundf(outputWeights[side * NNUE_HIDDEN + j] * NNUE_WEIGHT_SCALE);
+                    out.outputWeights[side][j] = int8_t(max(-127.0f, min(127.0f, value)));
+                }
+                out.outputBias[side] = int32_t(lroundf(outputBias[side] * NNUE_CLIP * NNUE_WEIGHT_SCALE));
             }
         }
+    };
 
-        // Helper function untuk menampilkan status fase
-        void printGameStatus() const {
-            cout << "Current turn: " << currentTurn << endl;
-            cout << "Macan phase: " << macanPhase << 
-                " (Remaining: " << remainingMacan << ")" << endl;
-            cout << "Uwong phase: " << uwongPhase << 
-                " (Remaining: " << remainingUwong << ")" << endl;
-        }
+    // Target latih dibatasi agar skor menang pasti tidak mendominasi error
+    const int NNUE_TARGET_LIMIT = 3000;
 
-    private:
-        void makeAIPlacement() {
-            // Implementasi sederhana: cari posisi kosong yang valid dengan skor tertinggi
-            int bestScore = -999999;
-            Position bestPos(-1, -1);
+    // Mode nnuetrain: latih bobot NNUE dari posisi permainan acak yang dinilai dengan pencarian
+    // dangkal (--depth 0 memakai evaluasi statis), lalu kuantisasi dan tulis ke berkas
+    int runNnueTraining(int argc, char* argv[]) {
+        string path = argc > 2 && argv[2][0] != '-' ? argv[2] : DEFAULT_NNUE_FILE;
+        int count = max(100, optionValue(argc, argv, "--positions", 100000));
+        int epochs = max(1, optionValue(argc, argv, "--epochs", 10));
+        int depth = max(0, optionValue(argc, argv, "--depth", 2));
+        int threads = max(1, optionValue(argc, argv, "--threads", int(thread::hardware_concurrency())));
+        mt19937 rng(uint32_t(optionValue(argc, argv, "--seed", 1)));
 
-            for (int y = 0; y < BOARD_HEIGHT; y++) {
-                for (int x = 0; x < BOARD_WIDTH; x++) {
-                    if (isPlayablePosition(x, y) && !isPositionOccupied(Position(x, y))) {
-                        // Coba tempatkan piece
-                        addPiece(aiPlayer, x, y);
-                        int score = evaluateBoard();
-                        
-                        // Undo placement
-                        pieces.pop_back();
-                        if (aiPlayer == "macan") remainingMacan++;
-                        else remainingUwong++;
-
-                        if (score > bestScore) {
-                            bestScore = score;
-                            bestPos = Position(x, y);
-                        }
-                    }
-                }
+        // Posisi dari permainan acak; posisi akhir permainan tidak dipakai
+        vector<NnueSample> samples;
+        while (int(samples.size()) < count) {
+            MacananGameState state;
+            for (int ply = 0; ply < 200 && int(samples.size()) < count; ply++) {
+                MoveList moves;
+                state.generateMoves(moves);
+                if (moves.empty() || state.isUwongDefeated()) break;
+                state.makeMove(moves[rng() % moves.size()]);
+                state.clearUndoStack();
+                if (!state.isUwongDefeated()) samples.push_back({state.pack(), 0.0f});
             }
+        }
 
-            if (bestPos.x != -1) {
-                addPiece(aiPlayer, bestPos.x, bestPos.y);
-                cout << "AI places " << aiPlayer << " at (" << bestPos.x << "," << bestPos.y << ")" << endl;
+        auto start = chrono::steady_clock::now();
+        atomic<size_t> next(0);
+        auto label = [&]() {
+            SearchEngine engine(max(depth, 1), 1);
+            MacananGameState state;
+            for (size_t i = next++; i < samples.size(); i = next++) {
+                const PackedPosition& position = samples[i].position;
+                Bitboard macans = position.macans & ~PACKED_UWONG_TO_MOVE;
+                Side side = (position.macans & PACKED_UWONG_TO_MOVE) ? SIDE_UWONG : SIDE_MACAN;
+                state.setPieces(macans, position.uwongs, side, MACAN_COUNT - popCount(macans), 0);
+                int score = depth > 0 ? engine.search(state).score : state.evaluateForSideToMove();
+                samples[i].target = float(max(-NNUE_TARGET_LIMIT, min(NNUE_TARGET_LIMIT, score)));
             }
-        }
+        };
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) workers.emplace_back(label);
+        for (thread& worker : workers) worker.join();
+        cout << "Labelled " << samples.size() << " positions at depth " << depth << " in "
+             << fixed << setprecision(1) << elapsedMilliseconds(start) / 1000.0 << " s" << endl;
 
-        void makeAIMovement() {
-            // Implementasi sederhana: cari gerakan dengan skor tertinggi
-            int bestScore = -999999;
-            Position bestFrom(-1, -1);
-            Position bestTo(-1, -1);
+        // 5% terakhir untuk validasi
+        shuffle(samples.begin(), samples.end(), rng);
+        size_t trainingCount = samples.size() - samples.size() / 20;
 
-            // Cari semua piece milik AI
-            for (const auto& piece : pieces) {
-                if (piece.pieceType == aiPlayer) {
-                    vector<Position> validMoves = getValidMoves(piece.position);
-                    
-                    for (const auto& move : validMoves) {
-                        // Coba gerakan
-                        Position originalPos = piece.position;
-                        movePiece(piece.position, move);
-                        int score = evaluateBoard();
-                        
-                        // Undo gerakan
-                        for (auto& p : pieces) {
-                            if (p.position == move) {
-                                p.position = originalPos;
-                                break;
-                            }
-                        }
+        NnueTrainingNetwork network;
+        normal_distribution<float> initial(0.0f, 0.1f);
+        network.featureWeights.resize(NNUE_INPUTS * NNUE_HIDDEN);
+        for (float& weight : network.featureWeights) weight = initial(rng);
+        network.featureBias.assign(NNUE_HIDDEN, 0.5f);
+        network.outputWeights.resize(2 * NNUE_HIDDEN);
+        for (float& weight : network.outputWeights) weight = initial(rng);
+        network.outputBias[0] = network.outputBias[1] = 0.0f;
 
-                        if (score > bestScore) {
-                            bestScore = score;
-                            bestFrom = piece.position;
-                            bestTo = move;
-                        }
-                    }
-                }
+        float rate = 0.01f;
+        for (int epoch = 1; epoch <= epochs; epoch++) {
+            shuffle(samples.begin(), samples.begin() + trainingCount, rng);
+            double trainingError = 0;
+            for (size_t i = 0; i < trainingCount; i++) {
+                const NnueSample& sample = samples[i];
+                trainingError += fabs(network.train(sample, sample.target / NNUE_OUTPUT_SCALE, rate));
             }
+            cout << "Epoch " << epoch << ": mean error " << setprecision(1)
+                 << trainingError / trainingCount * NNUE_OUTPUT_SCALE << endl;
+            rate *= 0.8f;
+        }
 
-            if (bestFrom.x != -1) {
-                movePiece(bestFrom, bestTo);
-                cout << "AI moves " << aiPlayer << " from (" << bestFrom.x << "," << bestFrom.y 
-                     << ") to (" << bestTo.x << "," << bestTo.y << ")" << endl;
-            }
+        unique_ptr<NnueWeights> quantized(new NnueWeights());
+        network.quantize(*quantized);
+        if (!NnueNetwork::save(path, *quantized)) {
+            cerr << "Cannot write " << path << endl;
+            return 1;
+        }
+
+        // Validasi lewat jalur inferensi sebenarnya (berkas yang baru ditulis)
+        NnueNetwork loaded;
+        if (!loaded.load(path)) {
+            cerr << "Cannot reload " << path << endl;
+            return 1;
+        }
+        double networkError = 0, handcraftedError = 0;
+        MacananGameState state;
+        for (size_t i = trainingCount; i < samples.size(); i++) {
+            const PackedPosition& position = samples[i].position;
+            Bitboard macans = position.macans & ~PACKED_UWONG_TO_MOVE;
+            Side side = (position.macans & PACKED_UWONG_TO_MOVE) ? SIDE_UWONG : SIDE_MACAN;
+            state.setPieces(macans, position.uwongs, side, MACAN_COUNT - popCount(macans), 0);
+            handcraftedError += fabs(state.evaluateForSideToMove() - samples[i].target);
+            state.setNetwork(&loaded);
+            networkError += fabs(state.evaluateForSideToMove() - samples[i].target);
+            state.setNetwork(nullptr);
+        }
+        size_t validation = max<size_t>(1, samples.size() - trainingCount);
+        cout << "Validation mean error: network " << networkError / validation
+             << ", handcrafted " << handcraftedError / validation << endl;
+        cout << "Written " << path << " (" << sizeof(NnueHeader) + sizeof(NnueWeights) << " bytes)" << endl;
+        return 0;
+    }
+
+    int main(int argc, char* argv[]) {
+        RULES.minUwong = max(0, min(UWONG_COUNT, optionValue(argc, argv, "--min-uwong", DEFAULT_MIN_UWONG)));
+        if (argc > 1 && string(argv[1]) == "serve") {
+            return runServer(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "loadgen") {
+            return runLoadGenerator(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "tune") {
+            return runTuner(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "nnuetrain") {
+            return runNnueTraining(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "smpbench") {
+            return runSmpBenchmark(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "evalbench") {
+            return runEvalBenchmark(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "solve") {
+            return runSolver(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "perft") {
+            return runPerft(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "selfplay") {
+            return runSelfPlay(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "tbgen") {
+            return runTablebaseGeneration(argc, argv);
+        }
+        if (argc > 1 && string(argv[1]) == "bookgen") {
+            return runBookGeneration(argc, argv);
         }
-    };
 
-    int main() {
         MacananGameState game;
         string playerChoice;
+
+        // Opsi: --engine alphabeta|mcts, --depth N untuk batas kedalaman pencarian AI, --hash MB
+        // untuk ukuran tabel transposisi, --nodes N (--playouts untuk MCTS), --movetime MS, atau
+        // --clock MS dan --increment MS untuk jam permainan AI, --threads N untuk jumlah thread
+        // pencarian, --tablebase FILE untuk akhir permainan, --book FILE untuk buku pembukaan,
+        // --nnue FILE untuk evaluator neural, --stats FILE untuk log instrumentasi per langkah
+        EndgameTablebase tablebase;
+        if (!loadTablebaseOption(argc, argv, tablebase)) return 1;
+        OpeningBook book;
+        if (!loadBookOption(argc, argv, book)) return 1;
+        NnueNetwork network;
+        if (!loadNetworkOption(argc, argv, "", network)) return 1;
+        EngineSettings settings = engineOptions(argc, argv, "", DEFAULT_SEARCH_DEPTH,
+                                                max(1, optionValue(argc, argv, "--hash", int(DEFAULT_HASH_MB))));
+        unique_ptr<AIEngine> engine = createEngine(settings, max(1, optionValue(argc, argv, "--threads", 1)),
+                                                   tablebase.isLoaded() ? &tablebase : nullptr,
+                                                   book.isLoaded() ? &book : nullptr,
+                                                   network.isLoaded() ? &network : nullptr);
+        GameClock aiClock(settings.clockMs, settings.incrementMs);
+        // Pondering selama menunggu input pemain; --no-ponder untuk mematikan
+        bool pondering = !hasOption(argc, argv, "--no-ponder");
+        Ponderer ponderer;
+        StatsLog statsLog;
+        string statsPath = optionString(argc, argv, "--stats", "");
+        if (!statsPath.empty() && !statsLog.open(statsPath)) {
+            cerr << "Cannot open stats log " << statsPath << endl;
+            return 1;
+        }
+        int ply = 0;
+        cout << "Rules: " << RULES.describe() << endl;
         
         // Pilih pemain
         while (playerChoice != "macan" && playerChoice != "uwong") {
@@ -575,10 +5475,45 @@
             game.printBoard();
             game.printGameStatus();
 
+            if (game.checkGameOver()) {
+                cout << "Winner: " << game.getWinner() << endl;
+                break;
+            }
+
             if (game.isAITurn()) {
                 cout << "AI's turn" << endl;
-                game.makeAIMove();
+                auto start = chrono::steady_clock::now();
+                SearchLimits limits = moveLimits(settings, aiClock);
+                MacananGameState position = game;
+                SearchResult result;
+                bool ponderHit = ponderer.finish(game, limits);
+                if (ponderHit) {
+                    result = ponderer.getResult();
+                    cout << "Ponder hit" << endl;
+                    game.playAIMove(result, elapsedMilliseconds(start));
+                } else {
+                    result = game.makeAIMove(*engine, limits);
+                }
+                if (statsLog.isOpen()) {
+                    string fields = "\"ply\":" + to_string(ply) + ",\"ponder_hit\":" + (ponderHit ? "true" : "false") + ",";
+                    statsLog.write(moveStatsJson(position, result, engine->getMoveStats(), elapsedMilliseconds(start),
+                                                 engineName(settings), fields));
+                }
+                if (aiClock.isEnabled()) {
+                    aiClock.consume(elapsedMilliseconds(start));
+                    if (aiClock.isFlagged()) {
+                        cout << "AI ran out of time. Winner: " << playerChoice << endl;
+                        break;
+                    }
+                    cout << "AI clock: " << fixed << setprecision(0) << aiClock.getRemaining() << " ms left" << endl;
+                }
                 game.switchTurn();
+                ply++;
+
+                // Balasan yang diperkirakan: langkah kedua PV
+                if (pondering && result.principalVariation.size() >= 2 && !game.checkGameOver()) {
+                    ponderer.start(*engine, game, result.principalVariation[1], moveLimits(settings, aiClock));
+                }
             } else {
                 string currentPhase = game.getGamePhase();
                 
@@ -610,6 +5545,7 @@
                     }
                 }
                 game.switchTurn();
+                ply++;
             }
         }
 